@@ -1,5 +1,5 @@
 if mg.need_generate() then
-	mg.configurations({"debug_coverage", "debug", "release"})
+	mg.configurations({"debug_coverage", "debug", "debug_compact_string", "release"})
 end
 
 local mincore = mg.project({
@@ -13,6 +13,9 @@ local mincore = mg.project({
 	debug = {
 		compile_options = {"-O0", "-Werror"}
 	},
+	debug_compact_string = {
+		compile_options = {"-O0", "-Werror", "-DSTRING_COMPACT"}
+	},
 	release = {
 		compile_options = {"-O2", "-Werror"}
 	},
@@ -32,6 +35,9 @@ local tests_exe = mg.project({
 	includes = {"src"},
 	compile_options = {"-g", "-O0", "-Wall", "-Wextra", "-Werror", "-Wno-dangling-else", "-fno-char8_t", "-nostdinc++", "--std=c++20", "-D_CRT_SECURE_NO_WARNINGS", "-fprofile-instr-generate", "-fcoverage-mapping"},
 	link_options = {linker_type_arg, "-g", "-fprofile-instr-generate", "-fcoverage-mapping"},
+	debug_compact_string = {
+		compile_options = {"-DSTRING_COMPACT"}
+	},
 	dependencies = {mincore}
 })
 
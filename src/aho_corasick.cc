@@ -0,0 +1,125 @@
+#include "aho_corasick.hh"
+
+namespace mc
+{
+	aho_corasick::aho_corasick(array_view<string_view> patterns)
+	{
+		// Class 0 gathers the bytes no pattern uses.
+		class_count_ = 1;
+		for (uint32_t i {0}; i < patterns.size(); ++i)
+		{
+			string_view pattern = patterns[i];
+			for (uint32_t j {0}; j < pattern.size(); ++j)
+			{
+				uint8_t byte = static_cast<uint8_t>(pattern[j]);
+				if (classes_[byte] == 0)
+					classes_[byte] = class_count_++;
+			}
+		}
+
+		// Trie of the patterns, UINT32_MAX marking missing transitions.
+		vector<vector<uint32_t>> outputs(1);
+		transitions_.resize(class_count_, UINT32_MAX);
+		sizes_.reserve(patterns.size());
+		for (uint32_t i {0}; i < patterns.size(); ++i)
+		{
+			string_view pattern = patterns[i];
+			sizes_.emplace_back(pattern.size());
+			if (pattern.empty())
+				continue;
+
+			uint32_t state {0};
+			for (uint32_t j {0}; j < pattern.size(); ++j)
+			{
+				uint32_t idx = state * class_count_ + classes_[uint8_t(pattern[j])];
+				if (transitions_[idx] == UINT32_MAX)
+				{
+					transitions_[idx] = outputs.size();
+					outputs.emplace_back();
+					transitions_.resize(transitions_.size() + class_count_, UINT32_MAX);
+				}
+				state = transitions_[idx];
+			}
+			outputs[state].emplace_back(i);
+		}
+
+		// Breadth first, the failure state of each state is known before its children:
+		// missing transitions are replaced by the ones of the failure state, and outputs
+		// of the failure state are added to the state.
+		uint32_t         state_count = outputs.size();
+		vector<uint32_t> fail(state_count, 0);
+		vector<uint32_t> queue;
+		queue.reserve(state_count);
+
+		for (uint32_t c {0}; c < class_count_; ++c)
+		{
+			uint32_t& next = transitions_[c];
+			if (next == UINT32_MAX)
+				next = 0;
+			else
+				queue.emplace_back(next);
+		}
+
+		for (uint32_t head {0}; head < queue.size(); ++head)
+		{
+			uint32_t state = queue[head];
+			for (uint32_t c {0}; c < class_count_; ++c)
+			{
+				uint32_t  fallback = transitions_[fail[state] * class_count_ + c];
+				uint32_t& next = transitions_[state * class_count_ + c];
+				if (next == UINT32_MAX)
+				{
+					next = fallback;
+					continue;
+				}
+
+				fail[next] = fallback;
+				vector<uint32_t> const& inherited = outputs[fallback];
+				for (uint32_t i {0}; i < inherited.size(); ++i)
+					outputs[next].emplace_back(inherited[i]);
+				queue.emplace_back(next);
+			}
+		}
+
+		output_offsets_.reserve(state_count + 1);
+		for (uint32_t state {0}; state < state_count; ++state)
+		{
+			output_offsets_.emplace_back(outputs_.size());
+			for (uint32_t i {0}; i < outputs[state].size(); ++i)
+				outputs_.emplace_back(outputs[state][i]);
+		}
+		output_offsets_.emplace_back(outputs_.size());
+	}
+
+	uint32_t aho_corasick::pattern_count() const
+	{
+		return sizes_.size();
+	}
+
+	uint32_t aho_corasick::state_count() const
+	{
+		return output_offsets_.size() - 1;
+	}
+
+	vector<aho_corasick::match> aho_corasick::find_all(string_view text) const
+	{
+		vector<match> res;
+		for_each_match(text, [&](match m) { res.emplace_back(m); });
+
+		return res;
+	}
+
+	bool aho_corasick::contains_any(string_view text) const
+	{
+		uint32_t state {0};
+		for (uint32_t i {0}; i < text.size(); ++i)
+		{
+			uint8_t byte = static_cast<uint8_t>(text[i]);
+			state = transitions_[state * class_count_ + classes_[byte]];
+			if (output_offsets_[state] != output_offsets_[state + 1])
+				return true;
+		}
+
+		return false;
+	}
+}
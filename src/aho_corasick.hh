@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+#include "string_view.hh"
+#include "vector.hh"
+
+namespace mc
+{
+	/// @brief Multi-pattern matcher, finding all the occurrences of a set of patterns in
+	/// a single pass over a text.
+	/// @details Patterns are compiled to an Aho-Corasick automaton whose failure links
+	/// are resolved at build time, so each text byte costs exactly one transition. Bytes
+	/// are mapped to classes (one per byte used by the patterns, plus one for all others)
+	/// and transitions are stored densely, state by state, in a single vector. Patterns
+	/// are not copied. Empty patterns never match.
+	class aho_corasick
+	{
+	public:
+		struct match
+		{
+			// Index of the pattern in the build array.
+			uint32_t pattern;
+			// Index of the first byte of the match in the text.
+			uint32_t idx;
+		};
+
+		aho_corasick(array_view<string_view> patterns);
+
+		uint32_t pattern_count() const;
+		uint32_t state_count() const;
+
+		// Calls f with each match, by increasing end index. Matches ending at the same
+		// index are reported from the longest pattern.
+		template <typename F>
+		void for_each_match(string_view text, F f) const;
+		vector<match> find_all(string_view text) const;
+		// True if any pattern occurs in text, stopping at the first match.
+		bool contains_any(string_view text) const;
+
+	private:
+		uint32_t class_count_ {0};
+		uint16_t classes_[256] {};
+		// Next state of state s for byte class c at s * class_count_ + c.
+		vector<uint32_t> transitions_;
+		// Patterns ending at state s, including through failure links, are
+		// outputs_[output_offsets_[s]] to outputs_[output_offsets_[s + 1]].
+		vector<uint32_t> output_offsets_;
+		vector<uint32_t> outputs_;
+		vector<uint32_t> sizes_;
+	};
+}
+
+namespace mc
+{
+	template <typename F>
+	void aho_corasick::for_each_match(string_view text, F f) const
+	{
+		uint32_t state {0};
+		for (uint32_t i {0}; i < text.size(); ++i)
+		{
+			uint8_t byte = static_cast<uint8_t>(text[i]);
+			state = transitions_[state * class_count_ + classes_[byte]];
+
+			for (uint32_t j = output_offsets_[state]; j < output_offsets_[state + 1]; ++j)
+			{
+				uint32_t pattern = outputs_[j];
+				f(match {pattern, i + 1 - sizes_[pattern]});
+			}
+		}
+	}
+}
@@ -0,0 +1,338 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+#include "bit.hh"
+#include "concepts.hh"
+#include "functional.hh"
+#include "pair.hh"
+#include "simd.hh"
+#include "span.hh"
+#include "type_traits.hh"
+#include "utility.hh"
+
+namespace mc
+{
+	// Algorithms on contiguous memory. Read-only ones take an array_view, in-place ones a
+	// span. Elements are referred to by index, UINT32_MAX meaning none.
+	// Each algorithm is specialized at compile time depending on T: arithmetic types use
+	// simd kernels or branchless loops that the compiler vectorizes, and trivially
+	// copyable types use memcpy/memset/memcmp when their bytes are enough to implement
+	// the operation.
+
+	// Index of the first element equal to val.
+	template <typename T>
+	uint32_t find(array_view<T> arr, type_identity_t<T> const& val);
+	// Index of the first element for which pred returns true.
+	template <typename T, typename Pred>
+	uint32_t find_if(array_view<T> arr, Pred pred);
+
+	template <typename T>
+	uint32_t count(array_view<T> arr, type_identity_t<T> const& val);
+	template <typename T, typename Pred>
+	uint32_t count_if(array_view<T> arr, Pred pred);
+
+	template <typename T>
+	void fill(span<T> arr, type_identity_t<T> const& val);
+	// Copies src at the beginning of dst, which must be at least as large. src and dst
+	// must not overlap.
+	template <typename T>
+	void copy(array_view<T> src, span<T> dst);
+
+	// True if both arrays have the same size and equal elements.
+	template <typename T>
+	bool equal(array_view<T> lhs, array_view<T> rhs);
+
+	// Index of the first smallest element, following Compare.
+	template <typename T, typename Compare = less<T>>
+	uint32_t min_element(array_view<T> arr, Compare comp = {});
+	// Index of the first largest element, following Compare.
+	template <typename T, typename Compare = less<T>>
+	uint32_t max_element(array_view<T> arr, Compare comp = {});
+	// Indices of the first smallest and the first largest elements. Integral types with
+	// the default Compare take two vectorized passes per bound, others a single pass.
+	template <typename T, typename Compare = less<T>>
+	pair<uint32_t, uint32_t> minmax_element(array_view<T> arr, Compare comp = {});
+
+	/// @brief Sum of init and all elements.
+	/// @details Floating point sums are computed with several partial sums to be
+	/// vectorized, so rounding may differ slightly from a sequential sum.
+	template <typename T>
+	T accumulate(array_view<T> arr, type_identity_t<T> init);
+	// Left fold of all elements with op, starting from init.
+	template <typename T, typename Op>
+	T accumulate(array_view<T> arr, type_identity_t<T> init, Op op);
+}
+
+namespace mc
+{
+	namespace __internal
+	{
+		// Types whose equality is the equality of their bytes.
+		template <typename T>
+		concept bitwise_comparable = integral<T> || pointer<T> || enumeration<T>;
+
+		template <arithmetic T>
+		uint32_t find_vectorized(T const* arr, uint32_t size, T val)
+		{
+			uint32_t i {0};
+			if constexpr (sizeof(T) == 1)
+			{
+				void const* res = size != 0 ? __builtin_memchr(arr, val, size) : nullptr;
+				return res ? static_cast<uint32_t>(static_cast<T const*>(res) - arr)
+				           : UINT32_MAX;
+			}
+			else if constexpr (sizeof(T) * 2 <= simd_width)
+			{
+				// Compare a register at a time, the first set bit of the mask being the
+				// first match.
+				using vec = native_simd<T>;
+
+				vec needle(val);
+				for (; i + vec::lanes <= size; i += vec::lanes)
+				{
+					auto mask = (vec::load(arr + i) == needle).bitmask();
+					if (mask != 0)
+						return i + countr_zero(mask);
+				}
+			}
+
+			for (; i < size; ++i)
+				if (arr[i] == val)
+					return i;
+
+			return UINT32_MAX;
+		}
+
+		template <arithmetic T>
+		T min_vectorized(T const* arr, uint32_t size)
+		{
+			T res = arr[0];
+			for (uint32_t i {1}; i < size; ++i)
+				res = arr[i] < res ? arr[i] : res;
+
+			return res;
+		}
+
+		template <arithmetic T>
+		T max_vectorized(T const* arr, uint32_t size)
+		{
+			T res = arr[0];
+			for (uint32_t i {1}; i < size; ++i)
+				res = res < arr[i] ? arr[i] : res;
+
+			return res;
+		}
+	}
+
+	template <typename T>
+	uint32_t find(array_view<T> arr, type_identity_t<T> const& val)
+	{
+		if constexpr (arithmetic<T>)
+			return __internal::find_vectorized(arr.data(), arr.size(), val);
+		else
+		{
+			for (uint32_t i {0}; i < arr.size(); ++i)
+				if (arr[i] == val)
+					return i;
+
+			return UINT32_MAX;
+		}
+	}
+
+	template <typename T, typename Pred>
+	uint32_t find_if(array_view<T> arr, Pred pred)
+	{
+		for (uint32_t i {0}; i < arr.size(); ++i)
+			if (pred(arr[i]))
+				return i;
+
+		return UINT32_MAX;
+	}
+
+	template <typename T>
+	uint32_t count(array_view<T> arr, type_identity_t<T> const& val)
+	{
+		// Branchless, vectorized for arithmetic types.
+		uint32_t res {0};
+		for (uint32_t i {0}; i < arr.size(); ++i)
+			res += arr[i] == val;
+
+		return res;
+	}
+
+	template <typename T, typename Pred>
+	uint32_t count_if(array_view<T> arr, Pred pred)
+	{
+		uint32_t res {0};
+		for (uint32_t i {0}; i < arr.size(); ++i)
+			res += pred(arr[i]) ? 1 : 0;
+
+		return res;
+	}
+
+	template <typename T>
+	void fill(span<T> arr, type_identity_t<T> const& val)
+	{
+		if (arr.empty())
+			return;
+
+		if constexpr (sizeof(T) == 1 && trivially_copyable<T>)
+			__builtin_memset(arr.data(), __builtin_bit_cast(unsigned char, val),
+			                 arr.size());
+		else
+		{
+			for (uint32_t i {0}; i < arr.size(); ++i)
+				arr[i] = val;
+		}
+	}
+
+	template <typename T>
+	void copy(array_view<T> src, span<T> dst)
+	{
+		if (src.empty())
+			return;
+
+		if constexpr (trivially_copyable<T>)
+			__builtin_memcpy(dst.data(), src.data(), sizeof(T) * src.size());
+		else
+		{
+			for (uint32_t i {0}; i < src.size(); ++i)
+				dst[i] = src[i];
+		}
+	}
+
+	template <typename T>
+	bool equal(array_view<T> lhs, array_view<T> rhs)
+	{
+		if (lhs.size() != rhs.size())
+			return false;
+		if (lhs.empty())
+			return true;
+
+		// Elements such as NaN aren't equal to themselves, so the same array is only
+		// equal to itself when comparing bytes.
+		if constexpr (__internal::bitwise_comparable<T>)
+		{
+			if (lhs.data() == rhs.data())
+				return true;
+
+			return __builtin_memcmp(lhs.data(), rhs.data(), sizeof(T) * lhs.size()) == 0;
+		}
+		else
+		{
+			for (uint32_t i {0}; i < lhs.size(); ++i)
+				if (!(lhs[i] == rhs[i]))
+					return false;
+
+			return true;
+		}
+	}
+
+	template <typename T, typename Compare>
+	uint32_t min_element(array_view<T> arr, Compare comp)
+	{
+		if (arr.empty())
+			return UINT32_MAX;
+
+		if constexpr (integral<T> && same_as<Compare, less<T>>)
+		{
+			// Finding the value vectorizes, finding its index doesn't: do it in two
+			// passes. Floating point types don't, a NaN value wouldn't be found.
+			T val = __internal::min_vectorized(arr.data(), arr.size());
+			return __internal::find_vectorized(arr.data(), arr.size(), val);
+		}
+		else
+		{
+			uint32_t res {0};
+			for (uint32_t i {1}; i < arr.size(); ++i)
+				if (comp(arr[i], arr[res]))
+					res = i;
+
+			return res;
+		}
+	}
+
+	template <typename T, typename Compare>
+	uint32_t max_element(array_view<T> arr, Compare comp)
+	{
+		if (arr.empty())
+			return UINT32_MAX;
+
+		if constexpr (integral<T> && same_as<Compare, less<T>>)
+		{
+			T val = __internal::max_vectorized(arr.data(), arr.size());
+			return __internal::find_vectorized(arr.data(), arr.size(), val);
+		}
+		else
+		{
+			uint32_t res {0};
+			for (uint32_t i {1}; i < arr.size(); ++i)
+				if (comp(arr[res], arr[i]))
+					res = i;
+
+			return res;
+		}
+	}
+
+	template <typename T, typename Compare>
+	pair<uint32_t, uint32_t> minmax_element(array_view<T> arr, Compare comp)
+	{
+		if (arr.empty())
+			return {UINT32_MAX, UINT32_MAX};
+
+		if constexpr (integral<T> && same_as<Compare, less<T>>)
+			return {min_element(arr, comp), max_element(arr, comp)};
+		else
+		{
+			pair<uint32_t, uint32_t> res {0, 0};
+			for (uint32_t i {1}; i < arr.size(); ++i)
+			{
+				if (comp(arr[i], arr[res.first]))
+					res.first = i;
+				else if (comp(arr[res.second], arr[i]))
+					res.second = i;
+			}
+
+			return res;
+		}
+	}
+
+	template <typename T>
+	T accumulate(array_view<T> arr, type_identity_t<T> init)
+	{
+		if constexpr (arithmetic<T>)
+		{
+			// Independent partial sums, so floating point additions don't form a
+			// single dependency chain and can be vectorized.
+			constexpr uint32_t lanes = 8;
+
+			T        sums[lanes] {};
+			uint32_t i {0};
+			for (; i + lanes <= arr.size(); i += lanes)
+				for (uint32_t j {0}; j < lanes; ++j)
+					sums[j] += arr[i + j];
+
+			for (; i < arr.size(); ++i)
+				init += arr[i];
+			for (uint32_t j {0}; j < lanes; ++j)
+				init += sums[j];
+
+			return init;
+		}
+		else
+			return accumulate(arr, move(init), [](T const& lhs, T const& rhs) {
+				return lhs + rhs;
+			});
+	}
+
+	template <typename T, typename Op>
+	T accumulate(array_view<T> arr, type_identity_t<T> init, Op op)
+	{
+		for (uint32_t i {0}; i < arr.size(); ++i)
+			init = op(move(init), arr[i]);
+
+		return init;
+	}
+}
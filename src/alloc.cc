@@ -15,7 +15,7 @@ namespace mc
 #ifdef _WIN32
 				return _aligned_malloc(size, alignment);
 #else
-				return aligned_alloc(size, alignment);
+				return aligned_alloc(alignment, size);
 #endif
 		}
 
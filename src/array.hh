@@ -4,6 +4,7 @@
 
 #include "array_view.hh"
 #include "concepts.hh"
+#include "span.hh"
 
 namespace mc
 {
@@ -17,6 +18,7 @@ namespace mc
 		constexpr T const* data() const&;
 
 		constexpr operator array_view<T>() const;
+		constexpr operator span<T>() &;
 
 		constexpr T&       operator[](uint32_t idx) &;
 		constexpr T const& operator[](uint32_t idx) const&;
@@ -67,6 +69,13 @@ namespace mc
 		return {arr_, S};
 	}
 
+	template <typename T, uint32_t S>
+		requires(S > 0)
+	constexpr array<T, S>::operator span<T>() &
+	{
+		return {arr_, S};
+	}
+
 	template <typename T, uint32_t S>
 		requires(S > 0)
 	constexpr T& array<T, S>::operator[](uint32_t idx) &
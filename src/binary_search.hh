@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+#include "functional.hh"
+#include "pair.hh"
+#include "type_traits.hh"
+
+namespace mc
+{
+	// Binary searches over sorted arrays. All of them are branchless: the loop always
+	// runs log2(size) iterations, and the only data dependent operation is a conditional
+	// move of the search base, so the CPU never mispredicts on the comparison result.
+	// The two possible next probes are prefetched, which hides most of the cache misses
+	// on arrays larger than the cache.
+	// Returned values are indices in the array, size() meaning no matching element.
+	// T is deduced from the array only, so vector<T> and array<T, S> can be passed by
+	// giving T explicitly.
+
+	template <typename T, typename Compare = less<T>>
+	uint32_t lower_bound(array_view<T> arr, type_identity_t<T> const& val,
+	                     Compare comp = {});
+
+	template <typename T, typename Compare = less<T>>
+	uint32_t upper_bound(array_view<T> arr, type_identity_t<T> const& val,
+	                     Compare comp = {});
+
+	template <typename T, typename Compare = less<T>>
+	pair<uint32_t, uint32_t> equal_range(array_view<T> arr, type_identity_t<T> const& val,
+	                                     Compare comp = {});
+
+	template <typename T, typename Compare = less<T>>
+	bool binary_search(array_view<T> arr, type_identity_t<T> const& val,
+	                   Compare comp = {});
+}
+
+namespace mc
+{
+	template <typename T, typename Compare>
+	uint32_t lower_bound(array_view<T> arr, type_identity_t<T> const& val, Compare comp)
+	{
+		if (arr.empty())
+			return 0;
+
+		T const* base = arr.data();
+		uint32_t len = arr.size();
+		while (len > 1)
+		{
+			uint32_t half = len / 2;
+			__builtin_prefetch(base + half / 2);
+			__builtin_prefetch(base + half + half / 2);
+			base = comp(base[half], val) ? base + half : base;
+			len -= half;
+		}
+
+		return static_cast<uint32_t>(base - arr.data()) + comp(*base, val);
+	}
+
+	template <typename T, typename Compare>
+	uint32_t upper_bound(array_view<T> arr, type_identity_t<T> const& val, Compare comp)
+	{
+		if (arr.empty())
+			return 0;
+
+		T const* base = arr.data();
+		uint32_t len = arr.size();
+		while (len > 1)
+		{
+			uint32_t half = len / 2;
+			__builtin_prefetch(base + half / 2);
+			__builtin_prefetch(base + half + half / 2);
+			base = comp(val, base[half]) ? base : base + half;
+			len -= half;
+		}
+
+		return static_cast<uint32_t>(base - arr.data()) + !comp(val, *base);
+	}
+
+	template <typename T, typename Compare>
+	pair<uint32_t, uint32_t> equal_range(array_view<T> arr, type_identity_t<T> const& val,
+	                                     Compare comp)
+	{
+		uint32_t first = lower_bound(arr, val, comp);
+		uint32_t last =
+			first + upper_bound(arr.subarr(first, arr.size() - first), val, comp);
+		return {first, last};
+	}
+
+	template <typename T, typename Compare>
+	bool binary_search(array_view<T> arr, type_identity_t<T> const& val, Compare comp)
+	{
+		uint32_t idx = lower_bound(arr, val, comp);
+		return idx != arr.size() && !comp(val, arr[idx]);
+	}
+}
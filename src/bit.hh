@@ -0,0 +1,269 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "concepts.hh"
+
+namespace mc
+{
+	// Bit manipulation, equivalent to the std <bit> header, on unsigned integers. All
+	// functions are constexpr and compile to single instructions where the target has
+	// them (popcnt, lzcnt/tzcnt, rol, bswap...).
+
+	enum class endian
+	{
+		little = __ORDER_LITTLE_ENDIAN__,
+		big = __ORDER_BIG_ENDIAN__,
+		native = __BYTE_ORDER__,
+	};
+
+	template <typename To, typename From>
+		requires(sizeof(To) == sizeof(From) && trivially_copyable<To> &&
+	             trivially_copyable<From>)
+	constexpr To bit_cast(From const& from);
+
+	template <unsigned_integral T>
+	constexpr uint32_t popcount(T val);
+
+	// Number of consecutive 0 bits, starting from the most significant bit. Returns the
+	// bit count of T if val is 0.
+	template <unsigned_integral T>
+	constexpr uint32_t countl_zero(T val);
+	// Number of consecutive 0 bits, starting from the least significant bit. Returns the
+	// bit count of T if val is 0.
+	template <unsigned_integral T>
+	constexpr uint32_t countr_zero(T val);
+	template <unsigned_integral T>
+	constexpr uint32_t countl_one(T val);
+	template <unsigned_integral T>
+	constexpr uint32_t countr_one(T val);
+
+	// True if val is a power of two.
+	template <unsigned_integral T>
+	constexpr bool has_single_bit(T val);
+	// Number of bits needed to store val, 0 for 0.
+	template <unsigned_integral T>
+	constexpr uint32_t bit_width(T val);
+	// Smallest power of two not less than val. val must not exceed the largest power of
+	// two of T.
+	template <unsigned_integral T>
+	constexpr T bit_ceil(T val);
+	// Largest power of two not greater than val, 0 for 0.
+	template <unsigned_integral T>
+	constexpr T bit_floor(T val);
+
+	template <unsigned_integral T>
+	constexpr T rotl(T val, int32_t shift);
+	template <unsigned_integral T>
+	constexpr T rotr(T val, int32_t shift);
+
+	// Reverses the byte order of val.
+	template <integral T>
+	constexpr T byteswap(T val);
+
+	// Conversions between the native byte order and a fixed one. Both directions are the
+	// same operation.
+	template <integral T>
+	constexpr T to_little_endian(T val);
+	template <integral T>
+	constexpr T to_big_endian(T val);
+
+	// Loads and stores through pointers without any alignment requirement, e.g. to read
+	// integers from a byte stream. They compile to plain moves on targets supporting
+	// unaligned accesses.
+	template <trivially_copyable T>
+	T load_unaligned(void const* ptr);
+	template <trivially_copyable T>
+	void store_unaligned(void* ptr, T val);
+
+	// Loads and stores of integers in a fixed byte order.
+	template <integral T>
+	T load_little_endian(void const* ptr);
+	template <integral T>
+	T load_big_endian(void const* ptr);
+	template <integral T>
+	void store_little_endian(void* ptr, T val);
+	template <integral T>
+	void store_big_endian(void* ptr, T val);
+}
+
+namespace mc
+{
+	namespace __internal
+	{
+		template <typename T>
+		constexpr uint32_t digits = sizeof(T) * 8;
+	}
+
+	template <typename To, typename From>
+		requires(sizeof(To) == sizeof(From) && trivially_copyable<To> &&
+	             trivially_copyable<From>)
+	constexpr To bit_cast(From const& from)
+	{
+		return __builtin_bit_cast(To, from);
+	}
+
+	template <unsigned_integral T>
+	constexpr uint32_t popcount(T val)
+	{
+		if constexpr (sizeof(T) <= sizeof(uint32_t))
+			return __builtin_popcount(val);
+		else
+			return __builtin_popcountll(val);
+	}
+
+	template <unsigned_integral T>
+	constexpr uint32_t countl_zero(T val)
+	{
+		if (val == 0)
+			return __internal::digits<T>;
+
+		// Smaller types are counted in a 32 bits integer, whose extra high bits are 0.
+		if constexpr (sizeof(T) <= sizeof(uint32_t))
+			return __builtin_clz(val) - (32 - __internal::digits<T>);
+		else
+			return __builtin_clzll(val);
+	}
+
+	template <unsigned_integral T>
+	constexpr uint32_t countr_zero(T val)
+	{
+		if (val == 0)
+			return __internal::digits<T>;
+
+		if constexpr (sizeof(T) <= sizeof(uint32_t))
+			return __builtin_ctz(val);
+		else
+			return __builtin_ctzll(val);
+	}
+
+	template <unsigned_integral T>
+	constexpr uint32_t countl_one(T val)
+	{
+		return countl_zero(static_cast<T>(~val));
+	}
+
+	template <unsigned_integral T>
+	constexpr uint32_t countr_one(T val)
+	{
+		return countr_zero(static_cast<T>(~val));
+	}
+
+	template <unsigned_integral T>
+	constexpr bool has_single_bit(T val)
+	{
+		return val != 0 && (val & (val - 1)) == 0;
+	}
+
+	template <unsigned_integral T>
+	constexpr uint32_t bit_width(T val)
+	{
+		return __internal::digits<T> - countl_zero(val);
+	}
+
+	template <unsigned_integral T>
+	constexpr T bit_ceil(T val)
+	{
+		if (val <= 1)
+			return 1;
+
+		return static_cast<T>(T(1) << bit_width(static_cast<T>(val - 1)));
+	}
+
+	template <unsigned_integral T>
+	constexpr T bit_floor(T val)
+	{
+		if (val == 0)
+			return 0;
+
+		return static_cast<T>(T(1) << (bit_width(val) - 1));
+	}
+
+	template <unsigned_integral T>
+	constexpr T rotl(T val, int32_t shift)
+	{
+		// Masked shifts, recognized as a rotation instruction.
+		constexpr uint32_t mask = __internal::digits<T> - 1;
+
+		uint32_t s = static_cast<uint32_t>(shift) & mask;
+		return static_cast<T>((val << s) | (val >> (-s & mask)));
+	}
+
+	template <unsigned_integral T>
+	constexpr T rotr(T val, int32_t shift)
+	{
+		constexpr uint32_t mask = __internal::digits<T> - 1;
+
+		uint32_t s = static_cast<uint32_t>(shift) & mask;
+		return static_cast<T>((val >> s) | (val << (-s & mask)));
+	}
+
+	template <integral T>
+	constexpr T byteswap(T val)
+	{
+		if constexpr (sizeof(T) == 1)
+			return val;
+		else if constexpr (sizeof(T) == 2)
+			return static_cast<T>(__builtin_bswap16(static_cast<uint16_t>(val)));
+		else if constexpr (sizeof(T) == 4)
+			return static_cast<T>(__builtin_bswap32(static_cast<uint32_t>(val)));
+		else
+			return static_cast<T>(__builtin_bswap64(static_cast<uint64_t>(val)));
+	}
+
+	template <integral T>
+	constexpr T to_little_endian(T val)
+	{
+		if constexpr (endian::native == endian::little)
+			return val;
+		else
+			return byteswap(val);
+	}
+
+	template <integral T>
+	constexpr T to_big_endian(T val)
+	{
+		if constexpr (endian::native == endian::big)
+			return val;
+		else
+			return byteswap(val);
+	}
+
+	template <trivially_copyable T>
+	T load_unaligned(void const* ptr)
+	{
+		T res;
+		__builtin_memcpy(&res, ptr, sizeof(T));
+		return res;
+	}
+
+	template <trivially_copyable T>
+	void store_unaligned(void* ptr, T val)
+	{
+		__builtin_memcpy(ptr, &val, sizeof(T));
+	}
+
+	template <integral T>
+	T load_little_endian(void const* ptr)
+	{
+		return to_little_endian(load_unaligned<T>(ptr));
+	}
+
+	template <integral T>
+	T load_big_endian(void const* ptr)
+	{
+		return to_big_endian(load_unaligned<T>(ptr));
+	}
+
+	template <integral T>
+	void store_little_endian(void* ptr, T val)
+	{
+		store_unaligned(ptr, to_little_endian(val));
+	}
+
+	template <integral T>
+	void store_big_endian(void* ptr, T val)
+	{
+		store_unaligned(ptr, to_big_endian(val));
+	}
+}
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+#include "bitset.hh"
+#include "vector.hh"
+
+namespace mc
+{
+	/// @brief Growable set of bits, packed in 64 bits words.
+	/// @details Same operations as bitset, the words being stored in a vector<uint64_t>.
+	/// Bulk operations require both operands to have the same size. Bits past size() in
+	/// the last word are always 0.
+	class bit_vector
+	{
+	public:
+		bit_vector() = default;
+		bit_vector(uint32_t size, bool val = false);
+
+		bool     empty() const;
+		uint32_t size() const;
+		// Capacity in bits, always a multiple of 64.
+		uint32_t capacity() const;
+
+		bool test(uint32_t idx) const;
+		bool operator[](uint32_t idx) const;
+
+		void set(uint32_t idx);
+		void set(uint32_t idx, bool val);
+		void reset(uint32_t idx);
+		void flip(uint32_t idx);
+
+		// Sets or clears count bits from first, a word at a time.
+		void set_range(uint32_t first, uint32_t count);
+		void reset_range(uint32_t first, uint32_t count);
+		void set_all();
+		void reset_all();
+		void flip_all();
+
+		void clear();
+		void reserve(uint32_t cap);
+		// New bits are set to val.
+		void resize(uint32_t size, bool val = false);
+		void push_back(bool val);
+		void pop_back();
+
+		uint32_t count() const;
+		bool     any() const;
+		bool     none() const;
+		bool     all() const;
+
+		// Index of the first set bit, or UINT32_MAX.
+		uint32_t find_first() const;
+		// Index of the first set bit at or after idx, or UINT32_MAX.
+		uint32_t find_next(uint32_t idx) const;
+		// Calls f with the index of each set bit, in increasing order.
+		template <typename F>
+		void for_each_set(F f) const;
+
+		bit_vector& operator&=(bit_vector const& other);
+		bit_vector& operator|=(bit_vector const& other);
+		bit_vector& operator^=(bit_vector const& other);
+		// Clears the bits set in other.
+		bit_vector& and_not(bit_vector const& other);
+
+		bool operator==(bit_vector const& other) const;
+
+		// Read-only, so that the bits past size() in the last word stay 0.
+		array_view<uint64_t> words() const&;
+
+	private:
+		vector<uint64_t> words_;
+		uint32_t         size_ {0};
+	};
+}
+
+namespace mc
+{
+	inline bit_vector::bit_vector(uint32_t size, bool val)
+	{
+		resize(size, val);
+	}
+
+	inline bool bit_vector::empty() const
+	{
+		return size_ == 0;
+	}
+
+	inline uint32_t bit_vector::size() const
+	{
+		return size_;
+	}
+
+	inline uint32_t bit_vector::capacity() const
+	{
+		return words_.capacity() * 64;
+	}
+
+	inline bool bit_vector::test(uint32_t idx) const
+	{
+		return (words_[idx / 64] >> (idx % 64)) & 1;
+	}
+
+	inline bool bit_vector::operator[](uint32_t idx) const
+	{
+		return test(idx);
+	}
+
+	inline void bit_vector::set(uint32_t idx)
+	{
+		words_[idx / 64] |= uint64_t(1) << (idx % 64);
+	}
+
+	inline void bit_vector::set(uint32_t idx, bool val)
+	{
+		uint64_t mask = uint64_t(1) << (idx % 64);
+		words_[idx / 64] = (words_[idx / 64] & ~mask) | (val ? mask : 0);
+	}
+
+	inline void bit_vector::reset(uint32_t idx)
+	{
+		words_[idx / 64] &= ~(uint64_t(1) << (idx % 64));
+	}
+
+	inline void bit_vector::flip(uint32_t idx)
+	{
+		words_[idx / 64] ^= uint64_t(1) << (idx % 64);
+	}
+
+	inline void bit_vector::set_range(uint32_t first, uint32_t count)
+	{
+		__internal::bit_fill(words_.data(), first, count, true);
+	}
+
+	inline void bit_vector::reset_range(uint32_t first, uint32_t count)
+	{
+		__internal::bit_fill(words_.data(), first, count, false);
+	}
+
+	inline void bit_vector::set_all()
+	{
+		__internal::bit_fill(words_.data(), 0, size_, true);
+	}
+
+	inline void bit_vector::reset_all()
+	{
+		__internal::bit_fill(words_.data(), 0, size_, false);
+	}
+
+	inline void bit_vector::flip_all()
+	{
+		if (empty())
+			return;
+
+		for (uint32_t i {0}; i < words_.size(); ++i)
+			words_[i] = ~words_[i];
+		words_.back() &= __internal::bit_last_mask(size_);
+	}
+
+	inline void bit_vector::clear()
+	{
+		words_.clear();
+		size_ = 0;
+	}
+
+	inline void bit_vector::reserve(uint32_t cap)
+	{
+		words_.reserve(__internal::bit_word_count(cap));
+	}
+
+	inline void bit_vector::resize(uint32_t size, bool val)
+	{
+		uint32_t old_size = size_;
+		words_.resize(__internal::bit_word_count(size), 0);
+		size_ = size;
+
+		if (size > old_size)
+			__internal::bit_fill(words_.data(), old_size, size - old_size, val);
+		else if (!words_.empty())
+			words_.back() &= __internal::bit_last_mask(size);
+	}
+
+	inline void bit_vector::push_back(bool val)
+	{
+		if (size_ % 64 == 0)
+			words_.emplace_back(0);
+
+		set(size_++, val);
+	}
+
+	inline void bit_vector::pop_back()
+	{
+		reset(--size_);
+		if (size_ % 64 == 0)
+			words_.pop_back();
+	}
+
+	inline uint32_t bit_vector::count() const
+	{
+		return __internal::bit_count(words_.data(), words_.size());
+	}
+
+	inline bool bit_vector::any() const
+	{
+		return find_first() != UINT32_MAX;
+	}
+
+	inline bool bit_vector::none() const
+	{
+		return !any();
+	}
+
+	inline bool bit_vector::all() const
+	{
+		return count() == size_;
+	}
+
+	inline uint32_t bit_vector::find_first() const
+	{
+		return __internal::bit_find_next(words_.data(), size_, 0);
+	}
+
+	inline uint32_t bit_vector::find_next(uint32_t idx) const
+	{
+		return __internal::bit_find_next(words_.data(), size_, idx);
+	}
+
+	template <typename F>
+	void bit_vector::for_each_set(F f) const
+	{
+		__internal::bit_for_each_set(words_.data(), words_.size(), f);
+	}
+
+	inline bit_vector& bit_vector::operator&=(bit_vector const& other)
+	{
+		__internal::bit_apply(words_.data(), other.words_.data(), words_.size(),
+		                      [](auto lhs, auto rhs) { return lhs & rhs; });
+		return *this;
+	}
+
+	inline bit_vector& bit_vector::operator|=(bit_vector const& other)
+	{
+		__internal::bit_apply(words_.data(), other.words_.data(), words_.size(),
+		                      [](auto lhs, auto rhs) { return lhs | rhs; });
+		return *this;
+	}
+
+	inline bit_vector& bit_vector::operator^=(bit_vector const& other)
+	{
+		__internal::bit_apply(words_.data(), other.words_.data(), words_.size(),
+		                      [](auto lhs, auto rhs) { return lhs ^ rhs; });
+		return *this;
+	}
+
+	inline bit_vector& bit_vector::and_not(bit_vector const& other)
+	{
+		__internal::bit_apply(words_.data(), other.words_.data(), words_.size(),
+		                      [](auto lhs, auto rhs) { return lhs & ~rhs; });
+		return *this;
+	}
+
+	inline bool bit_vector::operator==(bit_vector const& other) const
+	{
+		if (size_ != other.size_)
+			return false;
+		if (empty())
+			return true;
+
+		return __builtin_memcmp(words_.data(), other.words_.data(),
+		                        words_.size() * sizeof(uint64_t)) == 0;
+	}
+
+	inline array_view<uint64_t> bit_vector::words() const&
+	{
+		return words_;
+	}
+}
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+#include "bit.hh"
+#include "simd.hh"
+
+namespace mc
+{
+	/// @brief Fixed size set of bits, packed in 64 bits words.
+	/// @tparam N bit count.
+	/// @details Bulk operations (and, or, xor, and_not) work on whole SIMD registers, and
+	/// queries (count, find_first...) on whole words. Bits past N in the last word are
+	/// always 0.
+	template <uint32_t N>
+		requires(N > 0)
+	class bitset
+	{
+	public:
+		static constexpr uint32_t word_count = (N + 63) / 64;
+
+		constexpr uint32_t size() const;
+
+		bool test(uint32_t idx) const;
+		bool operator[](uint32_t idx) const;
+
+		void set(uint32_t idx);
+		void set(uint32_t idx, bool val);
+		void reset(uint32_t idx);
+		void flip(uint32_t idx);
+
+		// Sets or clears count bits from first, a word at a time.
+		void set_range(uint32_t first, uint32_t count);
+		void reset_range(uint32_t first, uint32_t count);
+		void set_all();
+		void reset_all();
+		void flip_all();
+
+		uint32_t count() const;
+		bool     any() const;
+		bool     none() const;
+		bool     all() const;
+
+		// Index of the first set bit, or UINT32_MAX.
+		uint32_t find_first() const;
+		// Index of the first set bit at or after idx, or UINT32_MAX.
+		uint32_t find_next(uint32_t idx) const;
+		// Calls f with the index of each set bit, in increasing order.
+		template <typename F>
+		void for_each_set(F f) const;
+
+		bitset& operator&=(bitset const& other);
+		bitset& operator|=(bitset const& other);
+		bitset& operator^=(bitset const& other);
+		// Clears the bits set in other.
+		bitset& and_not(bitset const& other);
+
+		bool operator==(bitset const& other) const;
+
+		// Read-only, so that the bits past size() in the last word stay 0.
+		array_view<uint64_t> words() const&;
+
+	private:
+		uint64_t words_[word_count] {};
+	};
+}
+
+namespace mc
+{
+	namespace __internal
+	{
+		// Word operations shared by bitset and bit_vector. Bits are stored from the least
+		// significant bit of the first word.
+
+		constexpr uint32_t bit_word_count(uint32_t bit_count)
+		{
+			return (bit_count + 63) / 64;
+		}
+
+		// Mask of the used bits of the last word.
+		constexpr uint64_t bit_last_mask(uint32_t bit_count)
+		{
+			uint32_t rem = bit_count % 64;
+			return rem ? (uint64_t(1) << rem) - 1 : UINT64_MAX;
+		}
+
+		// dst[i] = op(dst[i], src[i]), a SIMD register at a time. op is called with both
+		// uint64_t and native_simd<uint64_t>.
+		template <typename Op>
+		void bit_apply(uint64_t* dst, uint64_t const* src, uint32_t count, Op op)
+		{
+			using vec = native_simd<uint64_t>;
+
+			uint32_t i {0};
+			for (; i + vec::lanes <= count; i += vec::lanes)
+				op(vec::load(dst + i), vec::load(src + i)).store(dst + i);
+
+			for (; i < count; ++i)
+				dst[i] = op(dst[i], src[i]);
+		}
+
+		inline uint32_t bit_count(uint64_t const* words, uint32_t count)
+		{
+			uint32_t res {0};
+			for (uint32_t i {0}; i < count; ++i)
+				res += popcount(words[i]);
+
+			return res;
+		}
+
+		inline uint32_t bit_find_next(uint64_t const* words, uint32_t bit_count,
+		                              uint32_t idx)
+		{
+			if (idx >= bit_count)
+				return UINT32_MAX;
+
+			uint32_t word = idx / 64;
+			uint64_t bits = words[word] & (UINT64_MAX << (idx % 64));
+
+			uint32_t count = bit_word_count(bit_count);
+			while (bits == 0)
+			{
+				if (++word == count)
+					return UINT32_MAX;
+				bits = words[word];
+			}
+
+			return word * 64 + countr_zero(bits);
+		}
+
+		template <typename F>
+		void bit_for_each_set(uint64_t const* words, uint32_t count, F& f)
+		{
+			for (uint32_t i {0}; i < count; ++i)
+			{
+				// Clearing the lowest set bit each time visits only set bits.
+				for (uint64_t bits = words[i]; bits != 0; bits &= bits - 1)
+					f(i * 64 + countr_zero(bits));
+			}
+		}
+
+		inline void bit_fill(uint64_t* words, uint32_t first, uint32_t count, bool val)
+		{
+			if (count == 0)
+				return;
+
+			uint32_t last = first + count;
+			uint32_t first_word = first / 64;
+			uint32_t last_word = (last - 1) / 64;
+
+			uint64_t first_mask = UINT64_MAX << (first % 64);
+			uint64_t last_mask = bit_last_mask(last);
+			if (first_word == last_word)
+				first_mask &= last_mask;
+
+			auto fill_word = [val](uint64_t& word, uint64_t mask) {
+				word = val ? word | mask : word & ~mask;
+			};
+
+			fill_word(words[first_word], first_mask);
+			if (first_word == last_word)
+				return;
+
+			for (uint32_t i {first_word + 1}; i < last_word; ++i)
+				words[i] = val ? UINT64_MAX : 0;
+			fill_word(words[last_word], last_mask);
+		}
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	constexpr uint32_t bitset<N>::size() const
+	{
+		return N;
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	bool bitset<N>::test(uint32_t idx) const
+	{
+		return (words_[idx / 64] >> (idx % 64)) & 1;
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	bool bitset<N>::operator[](uint32_t idx) const
+	{
+		return test(idx);
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	void bitset<N>::set(uint32_t idx)
+	{
+		words_[idx / 64] |= uint64_t(1) << (idx % 64);
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	void bitset<N>::set(uint32_t idx, bool val)
+	{
+		uint64_t mask = uint64_t(1) << (idx % 64);
+		words_[idx / 64] = (words_[idx / 64] & ~mask) | (val ? mask : 0);
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	void bitset<N>::reset(uint32_t idx)
+	{
+		words_[idx / 64] &= ~(uint64_t(1) << (idx % 64));
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	void bitset<N>::flip(uint32_t idx)
+	{
+		words_[idx / 64] ^= uint64_t(1) << (idx % 64);
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	void bitset<N>::set_range(uint32_t first, uint32_t count)
+	{
+		__internal::bit_fill(words_, first, count, true);
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	void bitset<N>::reset_range(uint32_t first, uint32_t count)
+	{
+		__internal::bit_fill(words_, first, count, false);
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	void bitset<N>::set_all()
+	{
+		__internal::bit_fill(words_, 0, N, true);
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	void bitset<N>::reset_all()
+	{
+		for (uint32_t i {0}; i < word_count; ++i)
+			words_[i] = 0;
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	void bitset<N>::flip_all()
+	{
+		for (uint32_t i {0}; i < word_count; ++i)
+			words_[i] = ~words_[i];
+		words_[word_count - 1] &= __internal::bit_last_mask(N);
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	uint32_t bitset<N>::count() const
+	{
+		return __internal::bit_count(words_, word_count);
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	bool bitset<N>::any() const
+	{
+		return find_first() != UINT32_MAX;
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	bool bitset<N>::none() const
+	{
+		return !any();
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	bool bitset<N>::all() const
+	{
+		return count() == N;
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	uint32_t bitset<N>::find_first() const
+	{
+		return __internal::bit_find_next(words_, N, 0);
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	uint32_t bitset<N>::find_next(uint32_t idx) const
+	{
+		return __internal::bit_find_next(words_, N, idx);
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	template <typename F>
+	void bitset<N>::for_each_set(F f) const
+	{
+		__internal::bit_for_each_set(words_, word_count, f);
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	bitset<N>& bitset<N>::operator&=(bitset const& other)
+	{
+		__internal::bit_apply(words_, other.words_, word_count,
+		                      [](auto lhs, auto rhs) { return lhs & rhs; });
+		return *this;
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	bitset<N>& bitset<N>::operator|=(bitset const& other)
+	{
+		__internal::bit_apply(words_, other.words_, word_count,
+		                      [](auto lhs, auto rhs) { return lhs | rhs; });
+		return *this;
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	bitset<N>& bitset<N>::operator^=(bitset const& other)
+	{
+		__internal::bit_apply(words_, other.words_, word_count,
+		                      [](auto lhs, auto rhs) { return lhs ^ rhs; });
+		return *this;
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	bitset<N>& bitset<N>::and_not(bitset const& other)
+	{
+		__internal::bit_apply(words_, other.words_, word_count,
+		                      [](auto lhs, auto rhs) { return lhs & ~rhs; });
+		return *this;
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	bool bitset<N>::operator==(bitset const& other) const
+	{
+		return __builtin_memcmp(words_, other.words_, sizeof(words_)) == 0;
+	}
+
+	template <uint32_t N>
+		requires(N > 0)
+	array_view<uint64_t> bitset<N>::words() const&
+	{
+		return {words_, word_count};
+	}
+}
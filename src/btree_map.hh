@@ -0,0 +1,1060 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "alloc.hh"
+#include "array_view.hh"
+#include "binary_search.hh"
+#include "concepts.hh"
+#include "functional.hh"
+#include "pair.hh"
+#include "type_traits.hh"
+#include "utility.hh"
+
+namespace mc
+{
+	/// @brief Ordered associative container, implemented as a B+ tree.
+	/// @tparam K key type.
+	/// @tparam V value type.
+	/// @tparam Compare strict weak ordering of keys.
+	/// @details Nodes are around node_size bytes (4 cache lines), cache line aligned,
+	/// and allocated through mc::alloc, so each node holds tens of small entries and a
+	/// lookup touches a handful of nodes. Entries are stored in the leaves only, and
+	/// leaves are linked together, so ordered scans of a range only walk the leaf list.
+	/// Insertions and removals are O(log(size)), and never allocate per element.
+	/// For integral keys ordered with less<K>, the search inside a node counts the
+	/// keys smaller than the searched one instead of doing a binary search, which is
+	/// branchless and vectorized by the compiler.
+	/// Pointers to values and cursors are invalidated by insertions and removals.
+	template <typename K, typename V, typename Compare = less<K>>
+	class btree_map
+	{
+		struct leaf_node;
+
+	public:
+		template <bool Const>
+		class basic_cursor
+		{
+		public:
+			using value_ref = conditional_t<Const, V const&, V&>;
+
+			basic_cursor() = default;
+
+			bool      valid() const;
+			K const&  key() const;
+			value_ref value() const;
+
+			void next();
+			void prev();
+
+		private:
+			friend class btree_map;
+
+			basic_cursor(leaf_node* node, uint32_t idx);
+
+			leaf_node* node_ {nullptr};
+			uint32_t   idx_ {0};
+		};
+
+		using cursor = basic_cursor<false>;
+		using const_cursor = basic_cursor<true>;
+
+		btree_map() = default;
+		btree_map(btree_map const& other);
+		btree_map(btree_map&& other);
+		~btree_map();
+
+		btree_map& operator=(btree_map const& other);
+		btree_map& operator=(btree_map&& other);
+
+		bool     empty() const;
+		uint32_t size() const;
+
+		V*       find(K const& key) &;
+		V const* find(K const& key) const&;
+		bool     contains(K const& key) const;
+
+		V& operator[](K const& key) &
+			requires default_constructible<V>;
+
+		void clear();
+
+		// Inserts key if it isn't present. Returns the value of key and whether it was
+		// inserted.
+		pair<V*, bool> insert(K const& key, V const& val);
+		pair<V*, bool> insert_or_assign(K const& key, V const& val);
+
+		bool erase(K const& key);
+
+		cursor       first() &;
+		const_cursor first() const&;
+		cursor       last() &;
+		const_cursor last() const&;
+		// First entry whose key isn't ordered before key.
+		cursor       lower_bound(K const& key) &;
+		const_cursor lower_bound(K const& key) const&;
+		// First entry whose key is ordered after key.
+		cursor       upper_bound(K const& key) &;
+		const_cursor upper_bound(K const& key) const&;
+
+		// Calls f(key, value) for each entry in order.
+		template <typename F>
+		void for_each(F&& f) &;
+		template <typename F>
+		void for_each(F&& f) const&;
+		// Calls f(key, value) for each entry with a key in [first, last).
+		template <typename F>
+		void for_each(K const& first, K const& last, F&& f) &;
+		template <typename F>
+		void for_each(K const& first, K const& last, F&& f) const&;
+
+	private:
+		static constexpr uint32_t node_size = 256;
+		static constexpr uint32_t node_align = 64;
+		static constexpr uint32_t max_depth = 32;
+
+		static constexpr uint32_t leaf_cap =
+			(node_size - 24) / (sizeof(K) + sizeof(V)) > 4
+				? (node_size - 24) / (sizeof(K) + sizeof(V))
+				: 4;
+		static constexpr uint32_t inner_cap =
+			(node_size - 16) / (sizeof(K) + sizeof(void*)) > 4
+				? (node_size - 16) / (sizeof(K) + sizeof(void*))
+				: 4;
+		static constexpr uint32_t leaf_min = leaf_cap / 2;
+		static constexpr uint32_t inner_min = (inner_cap - 1) / 2;
+
+		struct node
+		{
+			uint32_t count;
+			bool     leaf;
+		};
+
+		struct alignas(node_align) leaf_node : node
+		{
+			K* keys();
+			V* values();
+
+			leaf_node* prev;
+			leaf_node* next;
+
+			alignas(K) unsigned char key_storage[sizeof(K) * leaf_cap];
+			alignas(V) unsigned char value_storage[sizeof(V) * leaf_cap];
+		};
+
+		// keys()[i] is the smallest key of children()[i + 1], or a key removed since
+		// that is still not greater than it.
+		struct alignas(node_align) inner_node : node
+		{
+			K*     keys();
+			node** children();
+
+			alignas(K) unsigned char key_storage[sizeof(K) * inner_cap];
+			node*                    child_storage[inner_cap + 1];
+		};
+
+		struct path_entry
+		{
+			inner_node* node;
+			uint32_t    child;
+		};
+
+		uint32_t lower_index(K* keys, uint32_t count, K const& key) const;
+		uint32_t upper_index(K* keys, uint32_t count, K const& key) const;
+
+		leaf_node* find_leaf(K const& key, path_entry* path, uint32_t& depth) const;
+
+		leaf_node*  new_leaf();
+		inner_node* new_inner();
+		void        free_node(node* n);
+		void        destroy(node* n);
+		node*       clone(node const* n, leaf_node*& prev_leaf);
+
+		// Inserts key at position idx in leaf, splitting nodes up to the root as needed.
+		// Returns the inserted value.
+		V* insert_at(leaf_node* leaf, uint32_t idx, path_entry* path, uint32_t depth,
+		             K const& key, V const& val);
+		void insert_child(path_entry* path, uint32_t depth, K const& sep, node* child);
+		void rebalance_leaf(leaf_node* leaf, path_entry* path, uint32_t depth);
+		void rebalance_inner(inner_node* n, path_entry* path, uint32_t depth);
+
+		node*      root_ {nullptr};
+		leaf_node* first_ {nullptr};
+		leaf_node* last_ {nullptr};
+		uint32_t   size_ {0};
+
+		[[no_unique_address]] Compare comp_;
+	};
+}
+
+namespace mc
+{
+	namespace __internal
+	{
+		// Helpers for node arrays, where each slot is either constructed or not.
+
+		// Moves count constructed elements from src to unconstructed dst.
+		template <typename T>
+		void btree_move(T* dst, T* src, uint32_t count)
+		{
+			for (uint32_t i {0}; i < count; ++i)
+			{
+				new (dst + i) T(move(src[i]));
+				src[i].~T();
+			}
+		}
+
+		// Opens an unconstructed slot at idx in an array of count constructed elements.
+		template <typename T>
+		void btree_shift_right(T* arr, uint32_t count, uint32_t idx)
+		{
+			for (uint32_t i {count}; i > idx; --i)
+			{
+				new (arr + i) T(move(arr[i - 1]));
+				arr[i - 1].~T();
+			}
+		}
+
+		// Closes the unconstructed slot at idx in an array of count slots.
+		template <typename T>
+		void btree_shift_left(T* arr, uint32_t count, uint32_t idx)
+		{
+			for (uint32_t i {idx}; i + 1 < count; ++i)
+			{
+				new (arr + i) T(move(arr[i + 1]));
+				arr[i + 1].~T();
+			}
+		}
+	}
+
+	template <typename K, typename V, typename Compare>
+	template <bool Const>
+	btree_map<K, V, Compare>::basic_cursor<Const>::basic_cursor(leaf_node* node,
+	                                                            uint32_t   idx)
+	: node_ {node}
+	, idx_ {idx}
+	{}
+
+	template <typename K, typename V, typename Compare>
+	template <bool Const>
+	bool btree_map<K, V, Compare>::basic_cursor<Const>::valid() const
+	{
+		return node_ != nullptr;
+	}
+
+	template <typename K, typename V, typename Compare>
+	template <bool Const>
+	K const& btree_map<K, V, Compare>::basic_cursor<Const>::key() const
+	{
+		return node_->keys()[idx_];
+	}
+
+	template <typename K, typename V, typename Compare>
+	template <bool Const>
+	btree_map<K, V, Compare>::basic_cursor<Const>::value_ref
+	btree_map<K, V, Compare>::basic_cursor<Const>::value() const
+	{
+		return node_->values()[idx_];
+	}
+
+	template <typename K, typename V, typename Compare>
+	template <bool Const>
+	void btree_map<K, V, Compare>::basic_cursor<Const>::next()
+	{
+		++idx_;
+		if (idx_ == node_->count)
+		{
+			node_ = node_->next;
+			idx_ = 0;
+		}
+	}
+
+	template <typename K, typename V, typename Compare>
+	template <bool Const>
+	void btree_map<K, V, Compare>::basic_cursor<Const>::prev()
+	{
+		if (idx_ == 0)
+		{
+			node_ = node_->prev;
+			idx_ = node_ ? node_->count - 1 : 0;
+		}
+		else
+			--idx_;
+	}
+
+	template <typename K, typename V, typename Compare>
+	K* btree_map<K, V, Compare>::leaf_node::keys()
+	{
+		return reinterpret_cast<K*>(key_storage);
+	}
+
+	template <typename K, typename V, typename Compare>
+	V* btree_map<K, V, Compare>::leaf_node::values()
+	{
+		return reinterpret_cast<V*>(value_storage);
+	}
+
+	template <typename K, typename V, typename Compare>
+	K* btree_map<K, V, Compare>::inner_node::keys()
+	{
+		return reinterpret_cast<K*>(key_storage);
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::node** btree_map<K, V, Compare>::inner_node::children()
+	{
+		return child_storage;
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::btree_map(btree_map const& other)
+	: size_ {other.size_}
+	, comp_ {other.comp_}
+	{
+		if (other.root_)
+		{
+			leaf_node* prev_leaf {nullptr};
+			root_ = clone(other.root_, prev_leaf);
+			last_ = prev_leaf;
+		}
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::btree_map(btree_map&& other)
+	: root_ {other.root_}
+	, first_ {other.first_}
+	, last_ {other.last_}
+	, size_ {other.size_}
+	, comp_ {other.comp_}
+	{
+		other.root_ = nullptr;
+		other.first_ = nullptr;
+		other.last_ = nullptr;
+		other.size_ = 0;
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::~btree_map()
+	{
+		clear();
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>& btree_map<K, V, Compare>::operator=(btree_map const& other)
+	{
+		if (this == &other)
+			return *this;
+
+		clear();
+		comp_ = other.comp_;
+		size_ = other.size_;
+		if (other.root_)
+		{
+			leaf_node* prev_leaf {nullptr};
+			root_ = clone(other.root_, prev_leaf);
+			last_ = prev_leaf;
+		}
+
+		return *this;
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>& btree_map<K, V, Compare>::operator=(btree_map&& other)
+	{
+		if (this == &other)
+			return *this;
+
+		clear();
+		root_ = other.root_;
+		first_ = other.first_;
+		last_ = other.last_;
+		size_ = other.size_;
+		comp_ = other.comp_;
+
+		other.root_ = nullptr;
+		other.first_ = nullptr;
+		other.last_ = nullptr;
+		other.size_ = 0;
+
+		return *this;
+	}
+
+	template <typename K, typename V, typename Compare>
+	bool btree_map<K, V, Compare>::empty() const
+	{
+		return size_ == 0;
+	}
+
+	template <typename K, typename V, typename Compare>
+	uint32_t btree_map<K, V, Compare>::size() const
+	{
+		return size_;
+	}
+
+	template <typename K, typename V, typename Compare>
+	V* btree_map<K, V, Compare>::find(K const& key) &
+	{
+		uint32_t   depth {0};
+		leaf_node* leaf = find_leaf(key, nullptr, depth);
+		if (!leaf)
+			return nullptr;
+
+		uint32_t idx = lower_index(leaf->keys(), leaf->count, key);
+		if (idx == leaf->count || comp_(key, leaf->keys()[idx]))
+			return nullptr;
+
+		return leaf->values() + idx;
+	}
+
+	template <typename K, typename V, typename Compare>
+	V const* btree_map<K, V, Compare>::find(K const& key) const&
+	{
+		return const_cast<btree_map*>(this)->find(key);
+	}
+
+	template <typename K, typename V, typename Compare>
+	bool btree_map<K, V, Compare>::contains(K const& key) const
+	{
+		return const_cast<btree_map*>(this)->find(key) != nullptr;
+	}
+
+	template <typename K, typename V, typename Compare>
+	V& btree_map<K, V, Compare>::operator[](K const& key) &
+		requires default_constructible<V>
+	{
+		path_entry path[max_depth];
+		uint32_t   depth {0};
+		leaf_node* leaf = find_leaf(key, path, depth);
+		if (leaf)
+		{
+			uint32_t idx = lower_index(leaf->keys(), leaf->count, key);
+			if (idx != leaf->count && !comp_(key, leaf->keys()[idx]))
+				return leaf->values()[idx];
+
+			return *insert_at(leaf, idx, path, depth, key, V {});
+		}
+
+		return *insert_at(nullptr, 0, path, depth, key, V {});
+	}
+
+	template <typename K, typename V, typename Compare>
+	void btree_map<K, V, Compare>::clear()
+	{
+		if (root_)
+			destroy(root_);
+
+		root_ = nullptr;
+		first_ = nullptr;
+		last_ = nullptr;
+		size_ = 0;
+	}
+
+	template <typename K, typename V, typename Compare>
+	pair<V*, bool> btree_map<K, V, Compare>::insert(K const& key, V const& val)
+	{
+		path_entry path[max_depth];
+		uint32_t   depth {0};
+		leaf_node* leaf = find_leaf(key, path, depth);
+		uint32_t   idx {0};
+		if (leaf)
+		{
+			idx = lower_index(leaf->keys(), leaf->count, key);
+			if (idx != leaf->count && !comp_(key, leaf->keys()[idx]))
+				return {leaf->values() + idx, false};
+		}
+
+		return {insert_at(leaf, idx, path, depth, key, val), true};
+	}
+
+	template <typename K, typename V, typename Compare>
+	pair<V*, bool> btree_map<K, V, Compare>::insert_or_assign(K const& key, V const& val)
+	{
+		pair<V*, bool> res = insert(key, val);
+		if (!res.second)
+			*res.first = val;
+
+		return res;
+	}
+
+	template <typename K, typename V, typename Compare>
+	bool btree_map<K, V, Compare>::erase(K const& key)
+	{
+		path_entry path[max_depth];
+		uint32_t   depth {0};
+		leaf_node* leaf = find_leaf(key, path, depth);
+		if (!leaf)
+			return false;
+
+		uint32_t idx = lower_index(leaf->keys(), leaf->count, key);
+		if (idx == leaf->count || comp_(key, leaf->keys()[idx]))
+			return false;
+
+		leaf->keys()[idx].~K();
+		leaf->values()[idx].~V();
+		__internal::btree_shift_left(leaf->keys(), leaf->count, idx);
+		__internal::btree_shift_left(leaf->values(), leaf->count, idx);
+		--leaf->count;
+		--size_;
+
+		if (depth == 0)
+		{
+			if (leaf->count == 0)
+			{
+				free_node(leaf);
+				root_ = nullptr;
+				first_ = nullptr;
+				last_ = nullptr;
+			}
+		}
+		else if (leaf->count < leaf_min)
+			rebalance_leaf(leaf, path, depth);
+
+		return true;
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::cursor btree_map<K, V, Compare>::first() &
+	{
+		return {first_, 0};
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::const_cursor btree_map<K, V, Compare>::first() const&
+	{
+		return {first_, 0};
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::cursor btree_map<K, V, Compare>::last() &
+	{
+		return {last_, last_ ? last_->count - 1 : 0};
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::const_cursor btree_map<K, V, Compare>::last() const&
+	{
+		return {last_, last_ ? last_->count - 1 : 0};
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::cursor btree_map<K, V, Compare>::lower_bound(K const& key) &
+	{
+		uint32_t   depth {0};
+		leaf_node* leaf = find_leaf(key, nullptr, depth);
+		if (!leaf)
+			return {};
+
+		uint32_t idx = lower_index(leaf->keys(), leaf->count, key);
+		if (idx == leaf->count)
+			return {leaf->next, 0};
+
+		return {leaf, idx};
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::const_cursor btree_map<K, V, Compare>::lower_bound(
+		K const& key) const&
+	{
+		cursor res = const_cast<btree_map*>(this)->lower_bound(key);
+		return {res.node_, res.idx_};
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::cursor btree_map<K, V, Compare>::upper_bound(K const& key) &
+	{
+		uint32_t   depth {0};
+		leaf_node* leaf = find_leaf(key, nullptr, depth);
+		if (!leaf)
+			return {};
+
+		uint32_t idx = upper_index(leaf->keys(), leaf->count, key);
+		if (idx == leaf->count)
+			return {leaf->next, 0};
+
+		return {leaf, idx};
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::const_cursor btree_map<K, V, Compare>::upper_bound(
+		K const& key) const&
+	{
+		cursor res = const_cast<btree_map*>(this)->upper_bound(key);
+		return {res.node_, res.idx_};
+	}
+
+	template <typename K, typename V, typename Compare>
+	template <typename F>
+	void btree_map<K, V, Compare>::for_each(F&& f) &
+	{
+		for (leaf_node* leaf {first_}; leaf; leaf = leaf->next)
+			for (uint32_t i {0}; i < leaf->count; ++i)
+				f(const_cast<K const&>(leaf->keys()[i]), leaf->values()[i]);
+	}
+
+	template <typename K, typename V, typename Compare>
+	template <typename F>
+	void btree_map<K, V, Compare>::for_each(F&& f) const&
+	{
+		for (leaf_node* leaf {first_}; leaf; leaf = leaf->next)
+			for (uint32_t i {0}; i < leaf->count; ++i)
+				f(const_cast<K const&>(leaf->keys()[i]),
+				  const_cast<V const&>(leaf->values()[i]));
+	}
+
+	template <typename K, typename V, typename Compare>
+	template <typename F>
+	void btree_map<K, V, Compare>::for_each(K const& first, K const& last, F&& f) &
+	{
+		cursor it = lower_bound(first);
+		if (!it.valid())
+			return;
+
+		// Scan the leaves directly, only the key comparison with last is needed.
+		leaf_node* leaf = it.node_;
+		uint32_t   i = it.idx_;
+		for (; leaf; leaf = leaf->next, i = 0)
+		{
+			for (; i < leaf->count; ++i)
+			{
+				if (!comp_(leaf->keys()[i], last))
+					return;
+
+				f(const_cast<K const&>(leaf->keys()[i]), leaf->values()[i]);
+			}
+		}
+	}
+
+	template <typename K, typename V, typename Compare>
+	template <typename F>
+	void btree_map<K, V, Compare>::for_each(K const& first, K const& last, F&& f) const&
+	{
+		const_cast<btree_map*>(this)->for_each(first, last, [&](K const& key, V& val) {
+			f(key, const_cast<V const&>(val));
+		});
+	}
+
+	template <typename K, typename V, typename Compare>
+	uint32_t btree_map<K, V, Compare>::lower_index(K* keys, uint32_t count,
+	                                               K const& key) const
+	{
+		if constexpr (integral<K> && same_as<Compare, less<K>>)
+		{
+			// Counting loop without early exit, vectorized by the compiler.
+			uint32_t idx {0};
+			for (uint32_t i {0}; i < count; ++i)
+				idx += keys[i] < key;
+			return idx;
+		}
+		else
+			return mc::lower_bound(array_view<K>(keys, count), key, comp_);
+	}
+
+	template <typename K, typename V, typename Compare>
+	uint32_t btree_map<K, V, Compare>::upper_index(K* keys, uint32_t count,
+	                                               K const& key) const
+	{
+		if constexpr (integral<K> && same_as<Compare, less<K>>)
+		{
+			uint32_t idx {0};
+			for (uint32_t i {0}; i < count; ++i)
+				idx += keys[i] <= key;
+			return idx;
+		}
+		else
+			return mc::upper_bound(array_view<K>(keys, count), key, comp_);
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::leaf_node* btree_map<K, V, Compare>::find_leaf(
+		K const& key, path_entry* path, uint32_t& depth) const
+	{
+		node* n = root_;
+		if (!n)
+			return nullptr;
+
+		while (!n->leaf)
+		{
+			inner_node* inner = static_cast<inner_node*>(n);
+			uint32_t    child = upper_index(inner->keys(), inner->count, key);
+			if (path)
+				path[depth] = {inner, child};
+			++depth;
+			n = inner->children()[child];
+		}
+
+		return static_cast<leaf_node*>(n);
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::leaf_node* btree_map<K, V, Compare>::new_leaf()
+	{
+		leaf_node* leaf = new (alloc(sizeof(leaf_node), alignof(leaf_node))) leaf_node;
+		leaf->count = 0;
+		leaf->leaf = true;
+		leaf->prev = nullptr;
+		leaf->next = nullptr;
+		return leaf;
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::inner_node* btree_map<K, V, Compare>::new_inner()
+	{
+		inner_node* inner =
+			new (alloc(sizeof(inner_node), alignof(inner_node))) inner_node;
+		inner->count = 0;
+		inner->leaf = false;
+		return inner;
+	}
+
+	template <typename K, typename V, typename Compare>
+	void btree_map<K, V, Compare>::free_node(node* n)
+	{
+		if (n->leaf)
+			free(n, sizeof(leaf_node), alignof(leaf_node));
+		else
+			free(n, sizeof(inner_node), alignof(inner_node));
+	}
+
+	template <typename K, typename V, typename Compare>
+	void btree_map<K, V, Compare>::destroy(node* n)
+	{
+		if (n->leaf)
+		{
+			leaf_node* leaf = static_cast<leaf_node*>(n);
+			for (uint32_t i {0}; i < leaf->count; ++i)
+			{
+				leaf->keys()[i].~K();
+				leaf->values()[i].~V();
+			}
+		}
+		else
+		{
+			inner_node* inner = static_cast<inner_node*>(n);
+			for (uint32_t i {0}; i < inner->count; ++i)
+				inner->keys()[i].~K();
+			for (uint32_t i {0}; i <= inner->count; ++i)
+				destroy(inner->children()[i]);
+		}
+
+		free_node(n);
+	}
+
+	template <typename K, typename V, typename Compare>
+	btree_map<K, V, Compare>::node* btree_map<K, V, Compare>::clone(node const* n,
+	                                                                leaf_node*& prev_leaf)
+	{
+		if (n->leaf)
+		{
+			leaf_node* src = static_cast<leaf_node*>(const_cast<node*>(n));
+			leaf_node* leaf = new_leaf();
+			for (uint32_t i {0}; i < src->count; ++i)
+			{
+				new (leaf->keys() + i) K(src->keys()[i]);
+				new (leaf->values() + i) V(src->values()[i]);
+			}
+			leaf->count = src->count;
+
+			// Leaves are cloned in order, so they can be linked on the fly.
+			leaf->prev = prev_leaf;
+			if (prev_leaf)
+				prev_leaf->next = leaf;
+			else
+				first_ = leaf;
+			prev_leaf = leaf;
+
+			return leaf;
+		}
+
+		inner_node* src = static_cast<inner_node*>(const_cast<node*>(n));
+		inner_node* inner = new_inner();
+		for (uint32_t i {0}; i < src->count; ++i)
+			new (inner->keys() + i) K(src->keys()[i]);
+		for (uint32_t i {0}; i <= src->count; ++i)
+			inner->children()[i] = clone(src->children()[i], prev_leaf);
+		inner->count = src->count;
+
+		return inner;
+	}
+
+	template <typename K, typename V, typename Compare>
+	V* btree_map<K, V, Compare>::insert_at(leaf_node* leaf, uint32_t idx,
+	                                       path_entry* path, uint32_t depth,
+	                                       K const& key, V const& val)
+	{
+		++size_;
+		if (!leaf)
+		{
+			leaf = new_leaf();
+			new (leaf->keys()) K(key);
+			new (leaf->values()) V(val);
+			leaf->count = 1;
+
+			root_ = leaf;
+			first_ = leaf;
+			last_ = leaf;
+			return leaf->values();
+		}
+
+		if (leaf->count < leaf_cap)
+		{
+			__internal::btree_shift_right(leaf->keys(), leaf->count, idx);
+			__internal::btree_shift_right(leaf->values(), leaf->count, idx);
+			new (leaf->keys() + idx) K(key);
+			new (leaf->values() + idx) V(val);
+			++leaf->count;
+			return leaf->values() + idx;
+		}
+
+		// Split the full leaf, so that both halves have at least leaf_min entries once
+		// the new one is inserted.
+		leaf_node* right = new_leaf();
+		uint32_t   split = idx < (leaf_cap + 1) / 2 ? leaf_cap / 2 : (leaf_cap + 1) / 2;
+		__internal::btree_move(right->keys(), leaf->keys() + split, leaf_cap - split);
+		__internal::btree_move(right->values(), leaf->values() + split, leaf_cap - split);
+		right->count = leaf_cap - split;
+		leaf->count = split;
+
+		right->next = leaf->next;
+		right->prev = leaf;
+		if (leaf->next)
+			leaf->next->prev = right;
+		else
+			last_ = right;
+		leaf->next = right;
+
+		leaf_node* target = leaf;
+		if (idx >= split)
+		{
+			target = right;
+			idx -= split;
+		}
+
+		__internal::btree_shift_right(target->keys(), target->count, idx);
+		__internal::btree_shift_right(target->values(), target->count, idx);
+		new (target->keys() + idx) K(key);
+		new (target->values() + idx) V(val);
+		++target->count;
+
+		V* res = target->values() + idx;
+		insert_child(path, depth, right->keys()[0], right);
+		return res;
+	}
+
+	template <typename K, typename V, typename Compare>
+	void btree_map<K, V, Compare>::insert_child(path_entry* path, uint32_t depth,
+	                                            K const& sep, node* child)
+	{
+		// Inserts (sep, child) right after the child at path[depth - 1], splitting inner
+		// nodes as long as they are full.
+		K     key(sep);
+		node* new_child = child;
+		while (depth > 0)
+		{
+			--depth;
+			inner_node* inner = path[depth].node;
+			uint32_t    idx = path[depth].child;
+
+			if (inner->count < inner_cap)
+			{
+				__internal::btree_shift_right(inner->keys(), inner->count, idx);
+				__internal::btree_shift_right(inner->children(), inner->count + 1,
+				                              idx + 1);
+				new (inner->keys() + idx) K(move(key));
+				inner->children()[idx + 1] = new_child;
+				++inner->count;
+				return;
+			}
+
+			// keys()[mid] moves up, the keys after it go to the right node.
+			inner_node* right = new_inner();
+			uint32_t    mid = inner_cap / 2;
+			__internal::btree_move(right->keys(), inner->keys() + mid + 1,
+			                       inner_cap - mid - 1);
+			__internal::btree_move(right->children(), inner->children() + mid + 1,
+			                       inner_cap - mid);
+			right->count = inner_cap - mid - 1;
+
+			K up(move(inner->keys()[mid]));
+			inner->keys()[mid].~K();
+			inner->count = mid;
+
+			inner_node* target = inner;
+			if (idx > mid)
+			{
+				target = right;
+				idx -= mid + 1;
+			}
+
+			__internal::btree_shift_right(target->keys(), target->count, idx);
+			__internal::btree_shift_right(target->children(), target->count + 1, idx + 1);
+			new (target->keys() + idx) K(move(key));
+			target->children()[idx + 1] = new_child;
+			++target->count;
+
+			key = move(up);
+			new_child = right;
+		}
+
+		// The root was split, grow the tree by one level.
+		inner_node* root = new_inner();
+		new (root->keys()) K(move(key));
+		root->children()[0] = root_;
+		root->children()[1] = new_child;
+		root->count = 1;
+		root_ = root;
+	}
+
+	template <typename K, typename V, typename Compare>
+	void btree_map<K, V, Compare>::rebalance_leaf(leaf_node* leaf, path_entry* path,
+	                                              uint32_t depth)
+	{
+		inner_node* parent = path[depth - 1].node;
+		uint32_t    idx = path[depth - 1].child;
+
+		leaf_node* left = idx > 0 ? static_cast<leaf_node*>(parent->children()[idx - 1])
+		                          : nullptr;
+		leaf_node* right = idx < parent->count
+		                       ? static_cast<leaf_node*>(parent->children()[idx + 1])
+		                       : nullptr;
+
+		if (left && left->count > leaf_min)
+		{
+			// Borrow the last entry of the left sibling.
+			__internal::btree_shift_right(leaf->keys(), leaf->count, 0);
+			__internal::btree_shift_right(leaf->values(), leaf->count, 0);
+			__internal::btree_move(leaf->keys(), left->keys() + left->count - 1, 1);
+			__internal::btree_move(leaf->values(), left->values() + left->count - 1, 1);
+			--left->count;
+			++leaf->count;
+			parent->keys()[idx - 1] = leaf->keys()[0];
+			return;
+		}
+
+		if (right && right->count > leaf_min)
+		{
+			// Borrow the first entry of the right sibling.
+			__internal::btree_move(leaf->keys() + leaf->count, right->keys(), 1);
+			__internal::btree_move(leaf->values() + leaf->count, right->values(), 1);
+			__internal::btree_shift_left(right->keys(), right->count, 0);
+			__internal::btree_shift_left(right->values(), right->count, 0);
+			--right->count;
+			++leaf->count;
+			parent->keys()[idx] = right->keys()[0];
+			return;
+		}
+
+		// Merge with a sibling, always into the left node of the pair.
+		uint32_t sep_idx = idx;
+		if (left)
+		{
+			right = leaf;
+			leaf = left;
+			sep_idx = idx - 1;
+		}
+
+		__internal::btree_move(leaf->keys() + leaf->count, right->keys(), right->count);
+		__internal::btree_move(leaf->values() + leaf->count, right->values(),
+		                       right->count);
+		leaf->count += right->count;
+
+		leaf->next = right->next;
+		if (right->next)
+			right->next->prev = leaf;
+		else
+			last_ = leaf;
+		free_node(right);
+
+		parent->keys()[sep_idx].~K();
+		__internal::btree_shift_left(parent->keys(), parent->count, sep_idx);
+		__internal::btree_shift_left(parent->children(), parent->count + 1, sep_idx + 1);
+		--parent->count;
+
+		rebalance_inner(parent, path, depth - 1);
+	}
+
+	template <typename K, typename V, typename Compare>
+	void btree_map<K, V, Compare>::rebalance_inner(inner_node* n, path_entry* path,
+	                                               uint32_t depth)
+	{
+		while (true)
+		{
+			if (depth == 0)
+			{
+				// Shrink the tree when the root has a single child left.
+				if (n->count == 0)
+				{
+					root_ = n->children()[0];
+					free_node(n);
+				}
+				return;
+			}
+
+			if (n->count >= inner_min)
+				return;
+
+			inner_node* parent = path[depth - 1].node;
+			uint32_t    idx = path[depth - 1].child;
+
+			inner_node* left =
+				idx > 0 ? static_cast<inner_node*>(parent->children()[idx - 1]) : nullptr;
+			inner_node* right = nullptr;
+			if (idx < parent->count)
+				right = static_cast<inner_node*>(parent->children()[idx + 1]);
+
+			if (left && left->count > inner_min)
+			{
+				// Rotate right through the parent separator.
+				__internal::btree_shift_right(n->keys(), n->count, 0);
+				__internal::btree_shift_right(n->children(), n->count + 1, 0);
+				new (n->keys()) K(move(parent->keys()[idx - 1]));
+				n->children()[0] = left->children()[left->count];
+				++n->count;
+
+				parent->keys()[idx - 1] = move(left->keys()[left->count - 1]);
+				left->keys()[left->count - 1].~K();
+				--left->count;
+				return;
+			}
+
+			if (right && right->count > inner_min)
+			{
+				// Rotate left through the parent separator.
+				new (n->keys() + n->count) K(move(parent->keys()[idx]));
+				n->children()[n->count + 1] = right->children()[0];
+				++n->count;
+
+				parent->keys()[idx] = move(right->keys()[0]);
+				right->keys()[0].~K();
+				__internal::btree_shift_left(right->keys(), right->count, 0);
+				__internal::btree_shift_left(right->children(), right->count + 1, 0);
+				--right->count;
+				return;
+			}
+
+			// Merge with a sibling and the separator between them, into the left node.
+			uint32_t sep_idx = idx;
+			if (left)
+			{
+				right = n;
+				n = left;
+				sep_idx = idx - 1;
+			}
+
+			new (n->keys() + n->count) K(move(parent->keys()[sep_idx]));
+			__internal::btree_move(n->keys() + n->count + 1, right->keys(), right->count);
+			__internal::btree_move(n->children() + n->count + 1, right->children(),
+			                       right->count + 1);
+			n->count += right->count + 1;
+			free_node(right);
+
+			parent->keys()[sep_idx].~K();
+			__internal::btree_shift_left(parent->keys(), parent->count, sep_idx);
+			__internal::btree_shift_left(parent->children(), parent->count + 1,
+			                             sep_idx + 1);
+			--parent->count;
+
+			n = parent;
+			--depth;
+		}
+	}
+}
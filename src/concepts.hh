@@ -52,6 +52,18 @@ namespace mc
 	template <typename T>
 	concept integral = __is_integral(T);
 
+	template <typename T>
+	concept signed_integral = integral<T> && T(-1) < T(0);
+
+	template <typename T>
+	concept unsigned_integral = integral<T> && !signed_integral<T>;
+
+	template <typename T>
+	concept floating_point = __is_floating_point(T);
+
+	template <typename T>
+	concept arithmetic = integral<T> || floating_point<T>;
+
 	template <typename T>
 	concept pointer = __is_pointer(T);
 
@@ -20,4 +20,10 @@
 // Size in bytes for the small string buffer, used for Small String Optimizations.
 // This should be always at least 16 bytes to use all the unused size of small string, and
 // multiple of 8 to prevent unused padding.
-#define STRING_SMALL_SIZE 16
\ No newline at end of file
+#define STRING_SMALL_SIZE 16
+
+// Store the size of small strings in the last byte of the small buffer instead of a
+// separate 32 bits field. The string keeps the same size (STRING_SMALL_SIZE + 8 bytes),
+// but holds up to STRING_SMALL_SIZE + 7 characters inline instead of
+// STRING_SMALL_SIZE - 1, i.e. 23 instead of 15 for a 24 bytes string.
+// #define STRING_COMPACT
\ No newline at end of file
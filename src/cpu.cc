@@ -0,0 +1,130 @@
+#include "cpu.hh"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#elif defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+namespace mc
+{
+	namespace
+	{
+		// Set once features are probed, so 0 means not probed yet.
+		constexpr uint64_t probed_bit = uint64_t(1) << 63;
+
+		uint64_t g_features {0};
+
+		constexpr uint64_t bit(cpu_feature feature)
+		{
+			return uint64_t(1) << static_cast<uint8_t>(feature);
+		}
+
+#if defined(__x86_64__) || defined(__i386__)
+		uint64_t probe()
+		{
+			uint64_t res {0};
+
+			uint32_t eax, ebx, ecx, edx;
+			if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+				return res;
+
+			if (edx & (1u << 26))
+				res |= bit(cpu_feature::sse2);
+			if (ecx & (1u << 0))
+				res |= bit(cpu_feature::sse3);
+			if (ecx & (1u << 9))
+				res |= bit(cpu_feature::ssse3);
+			if (ecx & (1u << 19))
+				res |= bit(cpu_feature::sse41);
+			if (ecx & (1u << 20))
+				res |= bit(cpu_feature::sse42);
+			if (ecx & (1u << 23))
+				res |= bit(cpu_feature::popcnt);
+
+			// AVX registers are usable only if the OS saves them on context switches,
+			// which it reports through XCR0.
+			uint64_t xcr0 {0};
+			if (ecx & (1u << 27))
+			{
+				uint32_t lo, hi;
+				__asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+				xcr0 = (uint64_t(hi) << 32) | lo;
+			}
+			bool avx_state = (xcr0 & 0x6) == 0x6;
+			bool avx512_state = (xcr0 & 0xe6) == 0xe6;
+
+			if (avx_state && (ecx & (1u << 28)))
+				res |= bit(cpu_feature::avx);
+			if (avx_state && (ecx & (1u << 12)))
+				res |= bit(cpu_feature::fma);
+
+			if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+				return res;
+
+			if (ebx & (1u << 3))
+				res |= bit(cpu_feature::bmi1);
+			if (ebx & (1u << 8))
+				res |= bit(cpu_feature::bmi2);
+			if (avx_state && (ebx & (1u << 5)))
+				res |= bit(cpu_feature::avx2);
+			if (avx512_state && (ebx & (1u << 16)))
+				res |= bit(cpu_feature::avx512f);
+			if (avx512_state && (ebx & (1u << 30)))
+				res |= bit(cpu_feature::avx512bw);
+			if (avx512_state && (ebx & (1u << 31)))
+				res |= bit(cpu_feature::avx512vl);
+
+			return res;
+		}
+#elif defined(__aarch64__)
+		uint64_t probe()
+		{
+			// NEON is part of the AArch64 baseline.
+			uint64_t res {bit(cpu_feature::neon)};
+
+#if defined(__linux__)
+			// Values of HWCAP_CRC32, HWCAP_ASIMDDP and HWCAP_SVE from <asm/hwcap.h>.
+			unsigned long hwcap = getauxval(AT_HWCAP);
+			if (hwcap & (1ul << 7))
+				res |= bit(cpu_feature::crc32);
+			if (hwcap & (1ul << 20))
+				res |= bit(cpu_feature::dotprod);
+			if (hwcap & (1ul << 22))
+				res |= bit(cpu_feature::sve);
+#else
+			// No portable runtime probe, rely on the compilation target.
+#if defined(__ARM_FEATURE_CRC32)
+			res |= bit(cpu_feature::crc32);
+#endif
+#if defined(__ARM_FEATURE_DOTPROD)
+			res |= bit(cpu_feature::dotprod);
+#endif
+#endif
+			return res;
+		}
+#else
+		uint64_t probe()
+		{
+			return 0;
+		}
+#endif
+	}
+
+	uint64_t cpu_features()
+	{
+		uint64_t features = __atomic_load_n(&g_features, __ATOMIC_RELAXED);
+		if (!features)
+		{
+			features = probe() | probed_bit;
+			__atomic_store_n(&g_features, features, __ATOMIC_RELAXED);
+		}
+
+		return features & ~probed_bit;
+	}
+
+	bool cpu_supports(cpu_feature feature)
+	{
+		return cpu_features() & bit(feature);
+	}
+}
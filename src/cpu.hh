@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace mc
+{
+	// Instruction set extensions which kernels can select at runtime.
+	enum class cpu_feature : uint8_t
+	{
+		// x86
+		sse2,
+		sse3,
+		ssse3,
+		sse41,
+		sse42,
+		popcnt,
+		avx,
+		avx2,
+		fma,
+		bmi1,
+		bmi2,
+		avx512f,
+		avx512bw,
+		avx512vl,
+
+		// ARM
+		neon,
+		crc32,
+		dotprod,
+		sve,
+	};
+
+	// Features of the running CPU, one bit per cpu_feature. Probed on first use only
+	// (cpuid on x86, hwcap on ARM Linux). On x86, AVX and AVX-512 features are only
+	// reported when the OS saves their registers.
+	uint64_t cpu_features();
+	bool     cpu_supports(cpu_feature feature);
+
+	template <typename Func>
+	class dispatched;
+
+	/// @brief Function resolved once, on its first call, between several
+	/// implementations.
+	/// @tparam R return type.
+	/// @tparam Args argument types.
+	/// @details The resolver returns the best implementation for the running CPU, usually
+	/// by testing cpu_supports(). Variants are written as regular functions with a
+	/// target attribute, for instance __attribute__((target("avx2"))), so templates such
+	/// as simd<T, N> inlined in them use the instructions of that target.
+	/// The constructor is constexpr, so global dispatched functions are initialized
+	/// before any code runs. Following calls cost an indirect call.
+	template <typename R, typename... Args>
+	class dispatched<R(Args...)>
+	{
+	public:
+		using func = R(Args...);
+		using resolver = func*();
+
+		constexpr dispatched(resolver* resolve);
+		dispatched(dispatched const&) = delete;
+
+		dispatched& operator=(dispatched const&) = delete;
+
+		R operator()(Args... args);
+
+		// Implementation selected for this CPU.
+		func* get();
+
+	private:
+		func*     impl_ {nullptr};
+		resolver* resolve_;
+	};
+}
+
+namespace mc
+{
+	template <typename R, typename... Args>
+	constexpr dispatched<R(Args...)>::dispatched(resolver* resolve)
+	: resolve_ {resolve}
+	{}
+
+	template <typename R, typename... Args>
+	R dispatched<R(Args...)>::operator()(Args... args)
+	{
+		return get()(static_cast<Args&&>(args)...);
+	}
+
+	template <typename R, typename... Args>
+	dispatched<R(Args...)>::func* dispatched<R(Args...)>::get()
+	{
+		// Concurrent first calls may all resolve, which is harmless since they find the
+		// same implementation.
+		func* impl = __atomic_load_n(&impl_, __ATOMIC_RELAXED);
+		if (!impl)
+		{
+			impl = resolve_();
+			__atomic_store_n(&impl_, impl, __ATOMIC_RELAXED);
+		}
+
+		return impl;
+	}
+}
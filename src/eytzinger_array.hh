@@ -0,0 +1,150 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+#include "bit.hh"
+#include "functional.hh"
+#include "vector.hh"
+
+namespace mc
+{
+	/// @brief Read-only sorted set, stored in the Eytzinger (BFS) layout of an implicit
+	/// binary search tree.
+	/// @tparam T type of stored elements.
+	/// @tparam Compare strict weak ordering the input array is sorted with.
+	/// @details The children of node k are stored at 2k and 2k + 1, so the first levels
+	/// of the tree share the same cache lines, and the descendants of a node 4 levels
+	/// down (for 4 bytes elements) are contiguous, and can be prefetched while the
+	/// current levels are compared. This makes lookups in tables much larger than the
+	/// cache mostly bound by the comparisons instead of the memory latency.
+	/// Search functions return a pointer in the layout, or nullptr if not found.
+	template <typename T, typename Compare = less<T>>
+	class eytzinger_array
+	{
+	public:
+		eytzinger_array() = default;
+		eytzinger_array(array_view<T> sorted);
+
+		bool     empty() const;
+		uint32_t size() const;
+		// Elements in BFS order, not in sorted order.
+		T const* data() const;
+
+		T const* lower_bound(T const& val) const;
+		T const* upper_bound(T const& val) const;
+		T const* find(T const& val) const;
+		bool     contains(T const& val) const;
+
+	private:
+		// Number of nodes covered by a cache line, used as prefetch distance.
+		static constexpr uint64_t prefetch_stride = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+		uint32_t build(array_view<T> sorted, uint32_t idx, uint32_t node);
+
+		// Nodes are 1-indexed, arr_[0] is a copy of the smallest element and is never
+		// read by searches.
+		vector<T> arr_;
+
+		[[no_unique_address]] Compare comp_;
+	};
+}
+
+namespace mc
+{
+	template <typename T, typename Compare>
+	eytzinger_array<T, Compare>::eytzinger_array(array_view<T> sorted)
+	{
+		if (sorted.empty())
+			return;
+
+		arr_.resize(sorted.size() + 1, sorted[0]);
+		build(sorted, 0, 1);
+	}
+
+	template <typename T, typename Compare>
+	bool eytzinger_array<T, Compare>::empty() const
+	{
+		return arr_.size() <= 1;
+	}
+
+	template <typename T, typename Compare>
+	uint32_t eytzinger_array<T, Compare>::size() const
+	{
+		return arr_.empty() ? 0 : arr_.size() - 1;
+	}
+
+	template <typename T, typename Compare>
+	T const* eytzinger_array<T, Compare>::data() const
+	{
+		return arr_.empty() ? nullptr : arr_.data() + 1;
+	}
+
+	template <typename T, typename Compare>
+	T const* eytzinger_array<T, Compare>::lower_bound(T const& val) const
+	{
+		uint32_t const n = size();
+		T const*       arr = arr_.data();
+
+		uint32_t k = 1;
+		while (k <= n)
+		{
+			__builtin_prefetch(arr + k * prefetch_stride);
+			k = 2 * k + comp_(arr[k], val);
+		}
+
+		// The path went right each time the node was smaller than val. Cancelling the
+		// trailing right turns, and the last left one, gives the last node which was
+		// not smaller than val.
+		k >>= countr_one(k) + 1;
+		return k ? arr + k : nullptr;
+	}
+
+	template <typename T, typename Compare>
+	T const* eytzinger_array<T, Compare>::upper_bound(T const& val) const
+	{
+		uint32_t const n = size();
+		T const*       arr = arr_.data();
+
+		uint32_t k = 1;
+		while (k <= n)
+		{
+			__builtin_prefetch(arr + k * prefetch_stride);
+			k = 2 * k + !comp_(val, arr[k]);
+		}
+
+		k >>= countr_one(k) + 1;
+		return k ? arr + k : nullptr;
+	}
+
+	template <typename T, typename Compare>
+	T const* eytzinger_array<T, Compare>::find(T const& val) const
+	{
+		T const* res = lower_bound(val);
+		if (res && !comp_(val, *res))
+			return res;
+
+		return nullptr;
+	}
+
+	template <typename T, typename Compare>
+	bool eytzinger_array<T, Compare>::contains(T const& val) const
+	{
+		return find(val) != nullptr;
+	}
+
+	template <typename T, typename Compare>
+	uint32_t eytzinger_array<T, Compare>::build(array_view<T> sorted, uint32_t idx,
+	                                            uint32_t node)
+	{
+		// In-order traversal of the implicit tree, filled from the sorted input.
+		if (node < arr_.size())
+		{
+			idx = build(sorted, idx, 2 * node);
+			arr_[node] = sorted[idx++];
+			idx = build(sorted, idx, 2 * node + 1);
+		}
+
+		return idx;
+	}
+}
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+#include "binary_search.hh"
+#include "concepts.hh"
+#include "functional.hh"
+#include "pair.hh"
+#include "sort.hh"
+#include "vector.hh"
+
+namespace mc
+{
+	/// @brief Sorted associative container, storing keys and values in two separate
+	/// vectors.
+	/// @tparam K key type.
+	/// @tparam V value type.
+	/// @tparam Compare strict weak ordering of keys.
+	/// @details Lookups are branchless binary searches over the keys only, which are
+	/// contiguous and not interleaved with values, so they use the cache much better than
+	/// node based maps. Insertion and removal are O(size), making this container best
+	/// for read-mostly tables built once, with the bulk constructors (sort once, then
+	/// remove duplicates).
+	/// Indices in both vectors are stable until the next insertion or removal.
+	template <typename K, typename V, typename Compare = less<K>>
+	class flat_map
+	{
+	public:
+		flat_map() = default;
+		// Bulk construction from unsorted keys and values of the same size. For
+		// duplicated keys, the first occurrence is kept.
+		flat_map(array_view<K> keys, array_view<V> values);
+		flat_map(array_view<pair<K, V>> items);
+
+		bool     empty() const;
+		uint32_t size() const;
+
+		array_view<K> keys() const&;
+		array_view<V> values() const&;
+
+		K const& key_at(uint32_t idx) const&;
+		V&       value_at(uint32_t idx) &;
+		V const& value_at(uint32_t idx) const&;
+
+		// Index of the first key not ordered before key, or size().
+		uint32_t lower_bound(K const& key) const;
+		// Index of key, or UINT32_MAX.
+		uint32_t index_of(K const& key) const;
+		bool     contains(K const& key) const;
+		V*       find(K const& key) &;
+		V const* find(K const& key) const&;
+
+		V& operator[](K const& key) &
+			requires default_constructible<V>;
+
+		void clear();
+		void reserve(uint32_t cap);
+
+		// Inserts key if it isn't present. Returns the index of key and whether it was
+		// inserted.
+		pair<uint32_t, bool> insert(K const& key, V const& val);
+		pair<uint32_t, bool> insert_or_assign(K const& key, V const& val);
+
+		bool erase(K const& key);
+		void erase_at(uint32_t idx);
+
+	private:
+		template <typename KeyAt, typename ValueAt>
+		void build(uint32_t size, KeyAt key_at, ValueAt value_at);
+
+		vector<K> keys_;
+		vector<V> values_;
+
+		[[no_unique_address]] Compare comp_;
+	};
+}
+
+namespace mc
+{
+	template <typename K, typename V, typename Compare>
+	flat_map<K, V, Compare>::flat_map(array_view<K> keys, array_view<V> values)
+	{
+		build(
+			keys.size(), [&](uint32_t idx) -> K const& { return keys[idx]; },
+			[&](uint32_t idx) -> V const& { return values[idx]; });
+	}
+
+	template <typename K, typename V, typename Compare>
+	flat_map<K, V, Compare>::flat_map(array_view<pair<K, V>> items)
+	{
+		build(
+			items.size(), [&](uint32_t idx) -> K const& { return items[idx].first; },
+			[&](uint32_t idx) -> V const& { return items[idx].second; });
+	}
+
+	template <typename K, typename V, typename Compare>
+	bool flat_map<K, V, Compare>::empty() const
+	{
+		return keys_.empty();
+	}
+
+	template <typename K, typename V, typename Compare>
+	uint32_t flat_map<K, V, Compare>::size() const
+	{
+		return keys_.size();
+	}
+
+	template <typename K, typename V, typename Compare>
+	array_view<K> flat_map<K, V, Compare>::keys() const&
+	{
+		return keys_;
+	}
+
+	template <typename K, typename V, typename Compare>
+	array_view<V> flat_map<K, V, Compare>::values() const&
+	{
+		return values_;
+	}
+
+	template <typename K, typename V, typename Compare>
+	K const& flat_map<K, V, Compare>::key_at(uint32_t idx) const&
+	{
+		return keys_[idx];
+	}
+
+	template <typename K, typename V, typename Compare>
+	V& flat_map<K, V, Compare>::value_at(uint32_t idx) &
+	{
+		return values_[idx];
+	}
+
+	template <typename K, typename V, typename Compare>
+	V const& flat_map<K, V, Compare>::value_at(uint32_t idx) const&
+	{
+		return values_[idx];
+	}
+
+	template <typename K, typename V, typename Compare>
+	uint32_t flat_map<K, V, Compare>::lower_bound(K const& key) const
+	{
+		return mc::lower_bound(array_view<K>(keys_), key, comp_);
+	}
+
+	template <typename K, typename V, typename Compare>
+	uint32_t flat_map<K, V, Compare>::index_of(K const& key) const
+	{
+		uint32_t idx = lower_bound(key);
+		if (idx == keys_.size() || comp_(key, keys_[idx]))
+			return UINT32_MAX;
+
+		return idx;
+	}
+
+	template <typename K, typename V, typename Compare>
+	bool flat_map<K, V, Compare>::contains(K const& key) const
+	{
+		return index_of(key) != UINT32_MAX;
+	}
+
+	template <typename K, typename V, typename Compare>
+	V* flat_map<K, V, Compare>::find(K const& key) &
+	{
+		uint32_t idx = index_of(key);
+		return idx == UINT32_MAX ? nullptr : values_.data() + idx;
+	}
+
+	template <typename K, typename V, typename Compare>
+	V const* flat_map<K, V, Compare>::find(K const& key) const&
+	{
+		uint32_t idx = index_of(key);
+		return idx == UINT32_MAX ? nullptr : values_.data() + idx;
+	}
+
+	template <typename K, typename V, typename Compare>
+	V& flat_map<K, V, Compare>::operator[](K const& key) &
+		requires default_constructible<V>
+	{
+		uint32_t idx = lower_bound(key);
+		if (idx == keys_.size() || comp_(key, keys_[idx]))
+		{
+			keys_.insert(idx, key);
+			values_.emplace(idx);
+		}
+
+		return values_[idx];
+	}
+
+	template <typename K, typename V, typename Compare>
+	void flat_map<K, V, Compare>::clear()
+	{
+		keys_.clear();
+		values_.clear();
+	}
+
+	template <typename K, typename V, typename Compare>
+	void flat_map<K, V, Compare>::reserve(uint32_t cap)
+	{
+		keys_.reserve(cap);
+		values_.reserve(cap);
+	}
+
+	template <typename K, typename V, typename Compare>
+	pair<uint32_t, bool> flat_map<K, V, Compare>::insert(K const& key, V const& val)
+	{
+		uint32_t idx = lower_bound(key);
+		if (idx != keys_.size() && !comp_(key, keys_[idx]))
+			return {idx, false};
+
+		keys_.insert(idx, key);
+		values_.insert(idx, val);
+		return {idx, true};
+	}
+
+	template <typename K, typename V, typename Compare>
+	pair<uint32_t, bool> flat_map<K, V, Compare>::insert_or_assign(K const& key,
+	                                                               V const& val)
+	{
+		uint32_t idx = lower_bound(key);
+		if (idx != keys_.size() && !comp_(key, keys_[idx]))
+		{
+			values_[idx] = val;
+			return {idx, false};
+		}
+
+		keys_.insert(idx, key);
+		values_.insert(idx, val);
+		return {idx, true};
+	}
+
+	template <typename K, typename V, typename Compare>
+	bool flat_map<K, V, Compare>::erase(K const& key)
+	{
+		uint32_t idx = index_of(key);
+		if (idx == UINT32_MAX)
+			return false;
+
+		erase_at(idx);
+		return true;
+	}
+
+	template <typename K, typename V, typename Compare>
+	void flat_map<K, V, Compare>::erase_at(uint32_t idx)
+	{
+		keys_.erase(idx);
+		values_.erase(idx);
+	}
+
+	template <typename K, typename V, typename Compare>
+	template <typename KeyAt, typename ValueAt>
+	void flat_map<K, V, Compare>::build(uint32_t size, KeyAt key_at, ValueAt value_at)
+	{
+		// Sort a permutation instead of the items, so keys and values are copied only
+		// once. Ties are broken by input position, to keep the first occurrence of
+		// duplicated keys.
+		vector<uint32_t> order;
+		order.reserve(size);
+		for (uint32_t i {0}; i < size; ++i)
+			order.emplace_back(i);
+
+		sort<uint32_t>(order, [&](uint32_t lhs, uint32_t rhs) {
+			if (comp_(key_at(lhs), key_at(rhs)))
+				return true;
+			if (comp_(key_at(rhs), key_at(lhs)))
+				return false;
+			return lhs < rhs;
+		});
+
+		keys_.reserve(size);
+		values_.reserve(size);
+		for (uint32_t i {0}; i < size; ++i)
+		{
+			K const& key = key_at(order[i]);
+			if (!keys_.empty() && !comp_(keys_.back(), key))
+				continue;
+
+			keys_.emplace_back(key);
+			values_.emplace_back(value_at(order[i]));
+		}
+	}
+}
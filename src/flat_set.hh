@@ -0,0 +1,182 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+#include "binary_search.hh"
+#include "functional.hh"
+#include "pair.hh"
+#include "sort.hh"
+#include "vector.hh"
+
+namespace mc
+{
+	/// @brief Sorted set, storing its keys in a vector.
+	/// @tparam K key type.
+	/// @tparam Compare strict weak ordering of keys.
+	/// @details See flat_map for the tradeoffs: fast and compact lookups, but O(size)
+	/// insertion and removal.
+	template <typename K, typename Compare = less<K>>
+	class flat_set
+	{
+	public:
+		flat_set() = default;
+		// Bulk construction from unsorted keys. Duplicated keys are removed.
+		flat_set(array_view<K> keys);
+
+		bool     empty() const;
+		uint32_t size() const;
+		K const* data() const&;
+
+		operator array_view<K>() const&;
+
+		K const& operator[](uint32_t idx) const&;
+
+		// Index of the first key not ordered before key, or size().
+		uint32_t lower_bound(K const& key) const;
+		// Index of key, or UINT32_MAX.
+		uint32_t index_of(K const& key) const;
+		bool     contains(K const& key) const;
+
+		void clear();
+		void reserve(uint32_t cap);
+
+		// Inserts key if it isn't present. Returns the index of key and whether it was
+		// inserted.
+		pair<uint32_t, bool> insert(K const& key);
+
+		bool erase(K const& key);
+		void erase_at(uint32_t idx);
+
+		// Delete const rvalue version of these functions, to prevent implicit conversion
+		// from rvalue to const lvalue
+		K const* data() const&& = delete;
+		operator array_view<K>() const&& = delete;
+		K const& operator[](uint32_t idx) const&& = delete;
+
+	private:
+		vector<K> keys_;
+
+		[[no_unique_address]] Compare comp_;
+	};
+}
+
+namespace mc
+{
+	template <typename K, typename Compare>
+	flat_set<K, Compare>::flat_set(array_view<K> keys)
+	{
+		keys_.reserve(keys.size());
+		for (uint32_t i {0}; i < keys.size(); ++i)
+			keys_.emplace_back(keys[i]);
+
+		sort<K>(keys_, comp_);
+
+		// Remove duplicates in place, keeping the first key of each run.
+		uint32_t size {0};
+		for (uint32_t i {0}; i < keys_.size(); ++i)
+		{
+			if (size != 0 && !comp_(keys_[size - 1], keys_[i]))
+				continue;
+
+			if (size != i)
+				keys_[size] = move(keys_[i]);
+			++size;
+		}
+
+		while (keys_.size() > size)
+			keys_.pop_back();
+	}
+
+	template <typename K, typename Compare>
+	bool flat_set<K, Compare>::empty() const
+	{
+		return keys_.empty();
+	}
+
+	template <typename K, typename Compare>
+	uint32_t flat_set<K, Compare>::size() const
+	{
+		return keys_.size();
+	}
+
+	template <typename K, typename Compare>
+	K const* flat_set<K, Compare>::data() const&
+	{
+		return keys_.data();
+	}
+
+	template <typename K, typename Compare>
+	flat_set<K, Compare>::operator array_view<K>() const&
+	{
+		return keys_;
+	}
+
+	template <typename K, typename Compare>
+	K const& flat_set<K, Compare>::operator[](uint32_t idx) const&
+	{
+		return keys_[idx];
+	}
+
+	template <typename K, typename Compare>
+	uint32_t flat_set<K, Compare>::lower_bound(K const& key) const
+	{
+		return mc::lower_bound(array_view<K>(keys_), key, comp_);
+	}
+
+	template <typename K, typename Compare>
+	uint32_t flat_set<K, Compare>::index_of(K const& key) const
+	{
+		uint32_t idx = lower_bound(key);
+		if (idx == keys_.size() || comp_(key, keys_[idx]))
+			return UINT32_MAX;
+
+		return idx;
+	}
+
+	template <typename K, typename Compare>
+	bool flat_set<K, Compare>::contains(K const& key) const
+	{
+		return index_of(key) != UINT32_MAX;
+	}
+
+	template <typename K, typename Compare>
+	void flat_set<K, Compare>::clear()
+	{
+		keys_.clear();
+	}
+
+	template <typename K, typename Compare>
+	void flat_set<K, Compare>::reserve(uint32_t cap)
+	{
+		keys_.reserve(cap);
+	}
+
+	template <typename K, typename Compare>
+	pair<uint32_t, bool> flat_set<K, Compare>::insert(K const& key)
+	{
+		uint32_t idx = lower_bound(key);
+		if (idx != keys_.size() && !comp_(key, keys_[idx]))
+			return {idx, false};
+
+		keys_.insert(idx, key);
+		return {idx, true};
+	}
+
+	template <typename K, typename Compare>
+	bool flat_set<K, Compare>::erase(K const& key)
+	{
+		uint32_t idx = index_of(key);
+		if (idx == UINT32_MAX)
+			return false;
+
+		keys_.erase(idx);
+		return true;
+	}
+
+	template <typename K, typename Compare>
+	void flat_set<K, Compare>::erase_at(uint32_t idx)
+	{
+		keys_.erase(idx);
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+namespace mc
+{
+	template <typename T>
+	struct less
+	{
+		constexpr bool operator()(T const& lhs, T const& rhs) const;
+	};
+
+	template <typename T>
+	struct greater
+	{
+		constexpr bool operator()(T const& lhs, T const& rhs) const;
+	};
+}
+
+namespace mc
+{
+	template <typename T>
+	constexpr bool less<T>::operator()(T const& lhs, T const& rhs) const
+	{
+		return lhs < rhs;
+	}
+
+	template <typename T>
+	constexpr bool greater<T>::operator()(T const& lhs, T const& rhs) const
+	{
+		return rhs < lhs;
+	}
+}
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "concepts.hh"
+#include "span.hh"
+#include "strided_view.hh"
+
+namespace mc
+{
+	/// @brief Multi-dimensional view over contiguous memory, not owning the data. Meant
+	/// for matrices (Rank 2) and images or volumes (Rank 2 or 3) stored in a vector.
+	/// @tparam T element type. Elements are mutable unless T is const.
+	/// @tparam Rank number of dimensions.
+	/// @details Layout is row-major, with the last dimension always contiguous: rows are
+	/// spans, on which loops vectorize, while columns are strided views. Other
+	/// dimensions have a stride, in elements, which can be larger than the dense one to
+	/// view a tile of a larger buffer (the pitch of an image). Extents and strides are
+	/// set at runtime, or deduced at compile time from multi-dimensional C arrays.
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	class md_view
+	{
+	public:
+		constexpr md_view() = default;
+		constexpr md_view(nullptr_t, uint32_t const (&)[Rank]) = delete;
+
+		// Dense layout.
+		constexpr md_view(T* data, uint32_t const (&extents)[Rank]);
+		// Strides of every dimension except the last one.
+		constexpr md_view(T* data, uint32_t const (&extents)[Rank],
+		                  uint32_t const (&strides)[Rank - 1]);
+
+		template <uint32_t R, uint32_t C>
+		constexpr md_view(T (&arr)[R][C])
+			requires(Rank == 2);
+		template <uint32_t D, uint32_t R, uint32_t C>
+		constexpr md_view(T (&arr)[D][R][C])
+			requires(Rank == 3);
+
+		constexpr bool     empty() const;
+		// Number of elements.
+		constexpr uint32_t size() const;
+		constexpr uint32_t extent(uint32_t dim) const;
+		constexpr uint32_t stride(uint32_t dim) const;
+		constexpr T*       data() const;
+
+		// True if there is no gap between rows, so the whole view is a single span.
+		constexpr bool contiguous() const;
+		// All elements in memory order. Only valid if contiguous() is true.
+		constexpr span<T> flat() const;
+
+		template <integral... Idx>
+			requires(sizeof...(Idx) == Rank)
+		constexpr T& operator()(Idx... idx) const;
+
+		// Slice at idx on the first dimension: a span<T> row for Rank 2, or a
+		// md_view<T, Rank - 1> otherwise.
+		constexpr auto operator[](uint32_t idx) const;
+
+		constexpr span<T> row(uint32_t idx) const
+			requires(Rank == 2);
+		constexpr strided_view<T> col(uint32_t idx) const
+			requires(Rank == 2);
+
+		// View of the block starting at offset, sharing the strides of this view.
+		constexpr md_view<T, Rank> subview(uint32_t const (&offset)[Rank],
+		                                   uint32_t const (&extents)[Rank]) const;
+
+	private:
+		template <typename U, uint32_t R>
+			requires(R >= 2)
+		friend class md_view;
+
+		T*       arr_ {nullptr};
+		uint32_t extents_[Rank] {};
+		uint32_t strides_[Rank - 1] {};
+	};
+}
+
+namespace mc
+{
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	constexpr md_view<T, Rank>::md_view(T* data, uint32_t const (&extents)[Rank])
+	: arr_ {data}
+	{
+		uint32_t stride {1};
+		for (uint32_t i {Rank}; i > 0; --i)
+		{
+			extents_[i - 1] = extents[i - 1];
+			if (i < Rank)
+				strides_[i - 1] = stride;
+			stride *= extents[i - 1];
+		}
+	}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	constexpr md_view<T, Rank>::md_view(T* data, uint32_t const (&extents)[Rank],
+	                                    uint32_t const (&strides)[Rank - 1])
+	: arr_ {data}
+	{
+		for (uint32_t i {0}; i < Rank; ++i)
+			extents_[i] = extents[i];
+		for (uint32_t i {0}; i < Rank - 1; ++i)
+			strides_[i] = strides[i];
+	}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	template <uint32_t R, uint32_t C>
+	constexpr md_view<T, Rank>::md_view(T (&arr)[R][C])
+		requires(Rank == 2)
+	: md_view(arr[0], {R, C})
+	{}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	template <uint32_t D, uint32_t R, uint32_t C>
+	constexpr md_view<T, Rank>::md_view(T (&arr)[D][R][C])
+		requires(Rank == 3)
+	: md_view(arr[0][0], {D, R, C})
+	{}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	constexpr bool md_view<T, Rank>::empty() const
+	{
+		return size() == 0;
+	}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	constexpr uint32_t md_view<T, Rank>::size() const
+	{
+		uint32_t size {1};
+		for (uint32_t i {0}; i < Rank; ++i)
+			size *= extents_[i];
+
+		return size;
+	}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	constexpr uint32_t md_view<T, Rank>::extent(uint32_t dim) const
+	{
+		return extents_[dim];
+	}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	constexpr uint32_t md_view<T, Rank>::stride(uint32_t dim) const
+	{
+		return dim == Rank - 1 ? 1 : strides_[dim];
+	}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	constexpr T* md_view<T, Rank>::data() const
+	{
+		return arr_;
+	}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	constexpr bool md_view<T, Rank>::contiguous() const
+	{
+		uint32_t stride {1};
+		for (uint32_t i {Rank - 1}; i > 0; --i)
+		{
+			stride *= extents_[i];
+			if (strides_[i - 1] != stride)
+				return false;
+		}
+
+		return true;
+	}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	constexpr span<T> md_view<T, Rank>::flat() const
+	{
+		return {arr_, size()};
+	}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	template <integral... Idx>
+		requires(sizeof...(Idx) == Rank)
+	constexpr T& md_view<T, Rank>::operator()(Idx... idx) const
+	{
+		uint32_t indices[Rank] {static_cast<uint32_t>(idx)...};
+
+		uint32_t offset {indices[Rank - 1]};
+		for (uint32_t i {0}; i < Rank - 1; ++i)
+			offset += indices[i] * strides_[i];
+
+		return arr_[offset];
+	}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	constexpr auto md_view<T, Rank>::operator[](uint32_t idx) const
+	{
+		if constexpr (Rank == 2)
+			return span<T>(arr_ + idx * strides_[0], extents_[1]);
+		else
+		{
+			md_view<T, Rank - 1> res;
+			res.arr_ = arr_ + idx * strides_[0];
+			for (uint32_t i {1}; i < Rank; ++i)
+				res.extents_[i - 1] = extents_[i];
+			for (uint32_t i {1}; i < Rank - 1; ++i)
+				res.strides_[i - 1] = strides_[i];
+
+			return res;
+		}
+	}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	constexpr span<T> md_view<T, Rank>::row(uint32_t idx) const
+		requires(Rank == 2)
+	{
+		return {arr_ + idx * strides_[0], extents_[1]};
+	}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	constexpr strided_view<T> md_view<T, Rank>::col(uint32_t idx) const
+		requires(Rank == 2)
+	{
+		return {arr_ + idx, extents_[0], strides_[0]};
+	}
+
+	template <typename T, uint32_t Rank>
+		requires(Rank >= 2)
+	constexpr md_view<T, Rank> md_view<T, Rank>::subview(
+		uint32_t const (&offset)[Rank], uint32_t const (&extents)[Rank]) const
+	{
+		md_view<T, Rank> res(*this);
+		res.arr_ += offset[Rank - 1];
+		for (uint32_t i {0}; i < Rank - 1; ++i)
+			res.arr_ += offset[i] * strides_[i];
+		for (uint32_t i {0}; i < Rank; ++i)
+			res.extents_[i] = extents[i];
+
+		return res;
+	}
+}
@@ -0,0 +1,432 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+#include "functional.hh"
+#include "utility.hh"
+#include "vector.hh"
+
+namespace mc
+{
+	/// @brief Priority queue, stored as an implicit d-ary heap in a vector.
+	/// @tparam T type of stored elements.
+	/// @tparam Compare strict weak ordering. top() is the element no other one is ordered
+	/// after, i.e. the largest one with less<T>. Use greater<T> for a min-queue.
+	/// @tparam Arity number of children per node.
+	/// @details A 4-ary heap is half as deep as a binary one, and the 4 children of a
+	/// node are contiguous (a single cache line for small T), so pop() does fewer
+	/// dependent cache misses for a few more comparisons per level.
+	template <typename T, typename Compare = less<T>, uint32_t Arity = 4>
+		requires(Arity >= 2)
+	class priority_queue
+	{
+	public:
+		priority_queue() = default;
+		// Heapify a copy of arr in O(size).
+		priority_queue(array_view<T> arr);
+
+		bool     empty() const;
+		uint32_t size() const;
+		// Elements in heap order.
+		array_view<T> values() const&;
+
+		T const& top() const&;
+
+		void clear();
+		void reserve(uint32_t cap);
+
+		void push(T const& val);
+		void push(T&& val);
+		template <typename... Args>
+		void emplace(Args&&... args);
+		void pop();
+
+	private:
+		vector<T> heap_;
+
+		[[no_unique_address]] Compare comp_;
+	};
+
+	/// @brief Priority queue of keys in [0, key_count), each with its own priority,
+	/// allowing to change the priority of a queued key (decrease-key), or to remove it.
+	/// @details Entries are stored in a d-ary heap like priority_queue, plus a key to
+	/// heap position table, updated on every move. This is the queue needed by
+	/// Dijkstra-like algorithms, where keys are node indices.
+	template <typename T, typename Compare = less<T>, uint32_t Arity = 4>
+		requires(Arity >= 2)
+	class indexed_priority_queue
+	{
+	public:
+		indexed_priority_queue() = default;
+		indexed_priority_queue(uint32_t key_count);
+
+		bool     empty() const;
+		uint32_t size() const;
+		uint32_t key_count() const;
+		bool     contains(uint32_t key) const;
+		T const& priority(uint32_t key) const&;
+
+		uint32_t top_key() const;
+		T const& top() const&;
+
+		void clear();
+
+		// key must not be already queued.
+		void push(uint32_t key, T const& prio);
+		// key must be queued. The new priority can be ordered before or after the
+		// previous one.
+		void update(uint32_t key, T const& prio);
+		// Pushes key if it isn't queued, or updates its priority otherwise. Returns
+		// true if key was pushed.
+		bool push_or_update(uint32_t key, T const& prio);
+		void pop();
+		void erase(uint32_t key);
+
+	private:
+		static constexpr uint32_t npos = UINT32_MAX;
+
+		struct entry
+		{
+			T        prio;
+			uint32_t key;
+		};
+
+		void sift_up(uint32_t idx);
+		void sift_down(uint32_t idx);
+
+		vector<entry>    heap_;
+		vector<uint32_t> pos_;
+
+		[[no_unique_address]] Compare comp_;
+	};
+}
+
+namespace mc
+{
+	namespace __internal
+	{
+		template <uint32_t Arity, typename T, typename Compare>
+		void dary_sift_up(T* heap, uint32_t idx, Compare& comp)
+		{
+			T val = move(heap[idx]);
+			while (idx > 0)
+			{
+				uint32_t parent = (idx - 1) / Arity;
+				if (!comp(heap[parent], val))
+					break;
+
+				heap[idx] = move(heap[parent]);
+				idx = parent;
+			}
+
+			heap[idx] = move(val);
+		}
+
+		template <uint32_t Arity, typename T, typename Compare>
+		void dary_sift_down(T* heap, uint32_t size, uint32_t idx, Compare& comp)
+		{
+			T val = move(heap[idx]);
+			while (true)
+			{
+				uint32_t first = Arity * idx + 1;
+				if (first >= size)
+					break;
+
+				uint32_t last = size - first < Arity ? size : first + Arity;
+				uint32_t child = first;
+				for (uint32_t i {first + 1}; i < last; ++i)
+					if (comp(heap[child], heap[i]))
+						child = i;
+
+				if (!comp(val, heap[child]))
+					break;
+
+				heap[idx] = move(heap[child]);
+				idx = child;
+			}
+
+			heap[idx] = move(val);
+		}
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	priority_queue<T, Compare, Arity>::priority_queue(array_view<T> arr)
+	{
+		heap_.reserve(arr.size());
+		for (uint32_t i {0}; i < arr.size(); ++i)
+			heap_.emplace_back(arr[i]);
+
+		// Floyd's heap construction: sift down every internal node, from the last one.
+		uint32_t size = heap_.size();
+		for (uint32_t i {size > 1 ? (size - 2) / Arity + 1 : 0}; i > 0; --i)
+			__internal::dary_sift_down<Arity>(heap_.data(), size, i - 1, comp_);
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	bool priority_queue<T, Compare, Arity>::empty() const
+	{
+		return heap_.empty();
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	uint32_t priority_queue<T, Compare, Arity>::size() const
+	{
+		return heap_.size();
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	array_view<T> priority_queue<T, Compare, Arity>::values() const&
+	{
+		return heap_;
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	T const& priority_queue<T, Compare, Arity>::top() const&
+	{
+		return heap_[0];
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	void priority_queue<T, Compare, Arity>::clear()
+	{
+		heap_.clear();
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	void priority_queue<T, Compare, Arity>::reserve(uint32_t cap)
+	{
+		heap_.reserve(cap);
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	void priority_queue<T, Compare, Arity>::push(T const& val)
+	{
+		heap_.emplace_back(val);
+		__internal::dary_sift_up<Arity>(heap_.data(), heap_.size() - 1, comp_);
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	void priority_queue<T, Compare, Arity>::push(T&& val)
+	{
+		heap_.emplace_back(move(val));
+		__internal::dary_sift_up<Arity>(heap_.data(), heap_.size() - 1, comp_);
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	template <typename... Args>
+	void priority_queue<T, Compare, Arity>::emplace(Args&&... args)
+	{
+		heap_.emplace_back(forward<Args>(args)...);
+		__internal::dary_sift_up<Arity>(heap_.data(), heap_.size() - 1, comp_);
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	void priority_queue<T, Compare, Arity>::pop()
+	{
+		uint32_t last = heap_.size() - 1;
+		if (last > 0)
+			heap_[0] = move(heap_[last]);
+
+		heap_.pop_back();
+		if (last > 1)
+			__internal::dary_sift_down<Arity>(heap_.data(), last, 0, comp_);
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	indexed_priority_queue<T, Compare, Arity>::indexed_priority_queue(uint32_t key_count)
+	: pos_(key_count, npos)
+	{}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	bool indexed_priority_queue<T, Compare, Arity>::empty() const
+	{
+		return heap_.empty();
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	uint32_t indexed_priority_queue<T, Compare, Arity>::size() const
+	{
+		return heap_.size();
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	uint32_t indexed_priority_queue<T, Compare, Arity>::key_count() const
+	{
+		return pos_.size();
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	bool indexed_priority_queue<T, Compare, Arity>::contains(uint32_t key) const
+	{
+		return pos_[key] != npos;
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	T const& indexed_priority_queue<T, Compare, Arity>::priority(uint32_t key) const&
+	{
+		return heap_[pos_[key]].prio;
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	uint32_t indexed_priority_queue<T, Compare, Arity>::top_key() const
+	{
+		return heap_[0].key;
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	T const& indexed_priority_queue<T, Compare, Arity>::top() const&
+	{
+		return heap_[0].prio;
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	void indexed_priority_queue<T, Compare, Arity>::clear()
+	{
+		for (uint32_t i {0}; i < heap_.size(); ++i)
+			pos_[heap_[i].key] = npos;
+
+		heap_.clear();
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	void indexed_priority_queue<T, Compare, Arity>::push(uint32_t key, T const& prio)
+	{
+		heap_.emplace_back(entry {prio, key});
+		pos_[key] = heap_.size() - 1;
+		sift_up(heap_.size() - 1);
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	void indexed_priority_queue<T, Compare, Arity>::update(uint32_t key, T const& prio)
+	{
+		uint32_t idx = pos_[key];
+		bool     up = comp_(heap_[idx].prio, prio);
+		heap_[idx].prio = prio;
+
+		if (up)
+			sift_up(idx);
+		else
+			sift_down(idx);
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	bool indexed_priority_queue<T, Compare, Arity>::push_or_update(uint32_t key,
+	                                                               T const& prio)
+	{
+		if (pos_[key] == npos)
+		{
+			push(key, prio);
+			return true;
+		}
+
+		update(key, prio);
+		return false;
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	void indexed_priority_queue<T, Compare, Arity>::pop()
+	{
+		erase(heap_[0].key);
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	void indexed_priority_queue<T, Compare, Arity>::erase(uint32_t key)
+	{
+		uint32_t idx = pos_[key];
+		uint32_t last = heap_.size() - 1;
+		pos_[key] = npos;
+
+		if (idx == last)
+		{
+			heap_.pop_back();
+			return;
+		}
+
+		// The last entry replaces the erased one, and can belong above or below it.
+		bool up = comp_(heap_[idx].prio, heap_[last].prio);
+		heap_[idx] = move(heap_[last]);
+		pos_[heap_[idx].key] = idx;
+		heap_.pop_back();
+
+		if (up)
+			sift_up(idx);
+		else
+			sift_down(idx);
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	void indexed_priority_queue<T, Compare, Arity>::sift_up(uint32_t idx)
+	{
+		entry val = move(heap_[idx]);
+		while (idx > 0)
+		{
+			uint32_t parent = (idx - 1) / Arity;
+			if (!comp_(heap_[parent].prio, val.prio))
+				break;
+
+			heap_[idx] = move(heap_[parent]);
+			pos_[heap_[idx].key] = idx;
+			idx = parent;
+		}
+
+		pos_[val.key] = idx;
+		heap_[idx] = move(val);
+	}
+
+	template <typename T, typename Compare, uint32_t Arity>
+		requires(Arity >= 2)
+	void indexed_priority_queue<T, Compare, Arity>::sift_down(uint32_t idx)
+	{
+		uint32_t size = heap_.size();
+		entry    val = move(heap_[idx]);
+		while (true)
+		{
+			uint32_t first = Arity * idx + 1;
+			if (first >= size)
+				break;
+
+			uint32_t last = size - first < Arity ? size : first + Arity;
+			uint32_t child = first;
+			for (uint32_t i {first + 1}; i < last; ++i)
+				if (comp_(heap_[child].prio, heap_[i].prio))
+					child = i;
+
+			if (!comp_(val.prio, heap_[child].prio))
+				break;
+
+			heap_[idx] = move(heap_[child]);
+			pos_[heap_[idx].key] = idx;
+			idx = child;
+		}
+
+		pos_[val.key] = idx;
+		heap_[idx] = move(val);
+	}
+}
@@ -0,0 +1,200 @@
+#include "rank_select.hh"
+
+#include "bit.hh"
+
+namespace mc
+{
+	namespace
+	{
+		constexpr uint32_t super_words = 32;
+		constexpr uint32_t block_words = 8;
+		constexpr uint32_t sample_rate = 8192;
+
+		uint32_t super_rank(uint64_t entry)
+		{
+			return static_cast<uint32_t>(entry);
+		}
+
+		// Count of the block-th 512 bits block, for the first three ones.
+		uint32_t block_count(uint64_t entry, uint32_t block)
+		{
+			return (entry >> (32 + 10 * block)) & 0x3ff;
+		}
+
+		// Index of the bit of word preceded by k set bits, k being less than
+		// popcount(word).
+		uint32_t select_in_word(uint64_t word, uint32_t k)
+		{
+#if defined(__BMI2__)
+			return countr_zero(__builtin_ia32_pdep_di(uint64_t(1) << k, word));
+#else
+			// Narrows down to a byte, then clears the remaining lower set bits.
+			uint32_t pos {0};
+			for (uint32_t width {32}; width >= 8; width /= 2)
+			{
+				uint32_t low = popcount(word & ((uint64_t(1) << width) - 1));
+				if (k >= low)
+				{
+					k -= low;
+					word >>= width;
+					pos += width;
+				}
+			}
+
+			for (; k > 0; --k)
+				word &= word - 1;
+			return pos + countr_zero(word);
+#endif
+		}
+	}
+
+	rank_select::rank_select(bit_vector const& bits)
+	: rank_select(bits.words(), bits.size())
+	{}
+
+	rank_select::rank_select(array_view<uint64_t> words, uint32_t size)
+	: size_ {size}
+	{
+		uint32_t word_count = (size + 63) / 64;
+		words_.reserve(word_count);
+		for (uint32_t i {0}; i < word_count; ++i)
+			words_.emplace_back(words[i]);
+
+		// Bits past size are cleared so they are never counted.
+		if (size % 64)
+			words_.back() &= (uint64_t(1) << (size % 64)) - 1;
+
+		build();
+	}
+
+	void rank_select::build()
+	{
+		uint32_t super_count = (words_.size() + super_words - 1) / super_words;
+		supers_.reserve(super_count + 1);
+
+		for (uint32_t super {0}; super < super_count; ++super)
+		{
+			uint64_t entry = count_;
+			for (uint32_t block {0}; block < 4; ++block)
+			{
+				uint32_t first = super * super_words + block * block_words;
+				uint32_t last = first + block_words;
+				if (last > words_.size())
+					last = words_.size();
+
+				uint32_t block_count {0};
+				for (uint32_t i {first}; i < last; ++i)
+					block_count += popcount(words_[i]);
+
+				// The last block count is implied by the next superblock.
+				if (block < 3)
+					entry |= uint64_t(block_count) << (32 + 10 * block);
+
+				// Samples the set bits of the block whose rank is a multiple of the rate.
+				uint32_t next = count_ + block_count;
+				while (samples_.size() * sample_rate < next)
+					samples_.emplace_back(super);
+				count_ = next;
+			}
+			supers_.emplace_back(entry);
+		}
+
+		supers_.emplace_back(count_);
+		samples_.emplace_back(super_count);
+	}
+
+	bool rank_select::empty() const
+	{
+		return size_ == 0;
+	}
+
+	uint32_t rank_select::size() const
+	{
+		return size_;
+	}
+
+	uint32_t rank_select::count() const
+	{
+		return count_;
+	}
+
+	bool rank_select::test(uint32_t idx) const
+	{
+		return (words_[idx / 64] >> (idx % 64)) & 1;
+	}
+
+	bool rank_select::operator[](uint32_t idx) const
+	{
+		return test(idx);
+	}
+
+	uint32_t rank_select::rank(uint32_t idx) const
+	{
+		uint64_t entry = supers_[idx / (super_words * 64)];
+		uint32_t res = super_rank(entry);
+
+		uint32_t block = (idx / (block_words * 64)) % 4;
+		for (uint32_t i {0}; i < block; ++i)
+			res += block_count(entry, i);
+
+		uint32_t word = idx / 64;
+		for (uint32_t i {word & ~(block_words - 1)}; i < word; ++i)
+			res += popcount(words_[i]);
+
+		if (idx % 64)
+			res += popcount(words_[word] & ((uint64_t(1) << (idx % 64)) - 1));
+
+		return res;
+	}
+
+	uint32_t rank_select::rank0(uint32_t idx) const
+	{
+		return idx - rank(idx);
+	}
+
+	uint32_t rank_select::select(uint32_t k) const
+	{
+		if (k >= count_)
+			return UINT32_MAX;
+
+		// Last superblock starting with at most k set bits, between the samples around k.
+		uint32_t lo = samples_[k / sample_rate];
+		uint32_t hi = samples_[k / sample_rate + 1];
+		while (lo < hi)
+		{
+			uint32_t mid = lo + (hi - lo + 1) / 2;
+			if (super_rank(supers_[mid]) <= k)
+				lo = mid;
+			else
+				hi = mid - 1;
+		}
+
+		uint64_t entry = supers_[lo];
+		k -= super_rank(entry);
+
+		uint32_t block {0};
+		for (; block < 3; ++block)
+		{
+			uint32_t count = block_count(entry, block);
+			if (k < count)
+				break;
+			k -= count;
+		}
+
+		uint32_t word = lo * super_words + block * block_words;
+		for (;; ++word)
+		{
+			uint32_t count = popcount(words_[word]);
+			if (k < count)
+				break;
+			k -= count;
+		}
+
+		return word * 64 + select_in_word(words_[word], k);
+	}
+
+	array_view<uint64_t> rank_select::words() const
+	{
+		return words_;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+#include "bit_vector.hh"
+#include "vector.hh"
+
+namespace mc
+{
+	/// @brief Immutable bit vector answering rank and select queries in constant time.
+	/// @details Bits are grouped in 2048 bits superblocks, each holding one 64 bits
+	/// entry: the number of set bits before the superblock in the low 32 bits, and the
+	/// counts of its first three 512 bits blocks in 10 bits fields. This is 3.1% of
+	/// overhead. rank then reads one entry and popcounts at most 8 words. select also
+	/// samples the superblock of every 8192-th set bit (0.4% for dense vectors), and
+	/// binary searches the superblocks between two samples.
+	class rank_select
+	{
+	public:
+		rank_select() = default;
+		rank_select(bit_vector const& bits);
+		// size is in bits, words holding at least (size + 63) / 64 words.
+		rank_select(array_view<uint64_t> words, uint32_t size);
+
+		bool     empty() const;
+		uint32_t size() const;
+		// Number of set bits.
+		uint32_t count() const;
+
+		bool test(uint32_t idx) const;
+		bool operator[](uint32_t idx) const;
+
+		// Number of set bits before idx, idx being at most size().
+		uint32_t rank(uint32_t idx) const;
+		// Number of unset bits before idx, idx being at most size().
+		uint32_t rank0(uint32_t idx) const;
+		// Index of the set bit preceded by k set bits, or UINT32_MAX if k >= count().
+		uint32_t select(uint32_t k) const;
+
+		array_view<uint64_t> words() const;
+
+	private:
+		void build();
+
+		vector<uint64_t> words_;
+		// One entry per superblock, plus a last one holding count_.
+		vector<uint64_t> supers_;
+		// Superblock of every 8192-th set bit, plus the last superblock.
+		vector<uint32_t> samples_;
+		uint32_t         size_ {0};
+		uint32_t         count_ {0};
+	};
+}
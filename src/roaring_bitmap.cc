@@ -0,0 +1,645 @@
+#include "roaring_bitmap.hh"
+
+#include "binary_search.hh"
+#include "bit.hh"
+#include "simd.hh"
+#include "sort.hh"
+#include "utility.hh"
+
+namespace mc
+{
+	namespace
+	{
+		using container = __internal::roaring_container;
+		using __internal::roaring_type;
+
+		// Index of the run containing low, or UINT32_MAX.
+		uint32_t find_run(container const& cont, uint16_t low)
+		{
+			// Last run starting at or before low.
+			uint32_t lo {0};
+			uint32_t hi = cont.values.size() / 2;
+			while (lo < hi)
+			{
+				uint32_t mid = lo + (hi - lo) / 2;
+				if (cont.values[mid * 2] <= low)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+
+			if (lo == 0 || cont.values[(lo - 1) * 2 + 1] < low)
+				return UINT32_MAX;
+			return lo - 1;
+		}
+
+		bool contains(container const& cont, uint16_t low)
+		{
+			switch (cont.type)
+			{
+			case roaring_type::array:
+				return binary_search<uint16_t>(cont.values, low);
+			case roaring_type::bitmap:
+				return (cont.words[low / 64] >> (low % 64)) & 1;
+			case roaring_type::run:
+				return find_run(cont, low) != UINT32_MAX;
+			}
+
+			return false;
+		}
+
+		void to_bitmap(container& cont)
+		{
+			if (cont.type == roaring_type::bitmap)
+				return;
+
+			vector<uint64_t> words(container::bitmap_words, 0);
+			if (cont.type == roaring_type::array)
+			{
+				for (uint32_t i {0}; i < cont.values.size(); ++i)
+					words[cont.values[i] / 64] |= uint64_t(1) << (cont.values[i] % 64);
+			}
+			else
+			{
+				for (uint32_t i {0}; i < cont.values.size(); i += 2)
+				{
+					uint32_t count = cont.values[i + 1] - cont.values[i] + 1;
+					__internal::bit_fill(words.data(), cont.values[i], count, true);
+				}
+			}
+
+			cont.type = roaring_type::bitmap;
+			cont.values = {};
+			cont.words = move(words);
+		}
+
+		void to_array(container& cont)
+		{
+			if (cont.type == roaring_type::array)
+				return;
+
+			vector<uint16_t> values;
+			values.reserve(cont.count);
+			if (cont.type == roaring_type::bitmap)
+			{
+				auto add = [&](uint32_t low) { values.emplace_back(low); };
+				__internal::bit_for_each_set(cont.words.data(), cont.words.size(), add);
+			}
+			else
+			{
+				for (uint32_t i {0}; i < cont.values.size(); i += 2)
+				{
+					for (uint32_t low = cont.values[i]; low <= cont.values[i + 1]; ++low)
+						values.emplace_back(low);
+				}
+			}
+
+			cont.type = roaring_type::array;
+			cont.values = move(values);
+			cont.words = {};
+		}
+
+		// Picks the smallest of array and bitmap for the count of cont.
+		void normalize(container& cont)
+		{
+			if (cont.count <= container::array_max)
+				to_array(cont);
+			else
+				to_bitmap(cont);
+		}
+
+		void recount(container& cont)
+		{
+			cont.count = __internal::bit_count(cont.words.data(), cont.words.size());
+		}
+
+		void to_run(container& cont)
+		{
+			if (cont.type == roaring_type::run)
+				return;
+
+			to_array(cont);
+			vector<uint16_t> runs;
+			for (uint32_t i {0}; i < cont.values.size(); ++i)
+			{
+				uint16_t low = cont.values[i];
+				if (runs.empty() || runs.back() + 1 != low)
+				{
+					runs.emplace_back(low);
+					runs.emplace_back(low);
+				}
+				else
+					runs.back() = low;
+			}
+
+			cont.type = roaring_type::run;
+			cont.values = move(runs);
+		}
+
+		uint32_t run_count(container const& cont)
+		{
+			if (cont.type == roaring_type::run)
+				return cont.values.size() / 2;
+
+			uint32_t res {0};
+			if (cont.type == roaring_type::array)
+			{
+				for (uint32_t i {0}; i < cont.values.size(); ++i)
+					res += i == 0 || cont.values[i - 1] + 1 != cont.values[i];
+				return res;
+			}
+
+			// A run starts at each set bit whose previous bit is unset.
+			uint64_t carry {0};
+			for (uint32_t i {0}; i < cont.words.size(); ++i)
+			{
+				uint64_t word = cont.words[i];
+				res += popcount(word & ~((word << 1) | carry));
+				carry = word >> 63;
+			}
+			return res;
+		}
+
+		uint32_t byte_size(container const& cont)
+		{
+			switch (cont.type)
+			{
+			case roaring_type::array:
+				return cont.count * 2;
+			case roaring_type::bitmap:
+				return container::bitmap_words * 8;
+			case roaring_type::run:
+				return cont.values.size() * 2;
+			}
+
+			return 0;
+		}
+
+		// Sorted union of two sorted arrays.
+		vector<uint16_t> merge_union(array_view<uint16_t> lhs, array_view<uint16_t> rhs)
+		{
+			vector<uint16_t> res;
+			res.reserve(lhs.size() + rhs.size());
+
+			uint32_t i {0}, j {0};
+			while (i < lhs.size() && j < rhs.size())
+			{
+				uint16_t val = lhs[i] < rhs[j] ? lhs[i] : rhs[j];
+				i += lhs[i] == val;
+				j += rhs[j] == val;
+				res.emplace_back(val);
+			}
+			for (; i < lhs.size(); ++i)
+				res.emplace_back(lhs[i]);
+			for (; j < rhs.size(); ++j)
+				res.emplace_back(rhs[j]);
+
+			return res;
+		}
+
+		// Sorted intersection of two sorted arrays. Each value of the smaller one is
+		// compared to a block of 8 values of the larger one at once.
+		vector<uint16_t> merge_intersection(array_view<uint16_t> lhs,
+		                                    array_view<uint16_t> rhs)
+		{
+			using vec = simd<uint16_t, 8>;
+
+			if (lhs.size() > rhs.size())
+				swap(lhs, rhs);
+
+			vector<uint16_t> res;
+			res.reserve(lhs.size());
+
+			uint32_t j {0};
+			for (uint32_t i {0}; i < lhs.size(); ++i)
+			{
+				uint16_t val = lhs[i];
+				while (j + vec::lanes <= rhs.size() && rhs[j + vec::lanes - 1] < val)
+					j += vec::lanes;
+
+				if (j + vec::lanes <= rhs.size())
+				{
+					if ((vec::load(rhs.data() + j) == vec(val)).any())
+						res.emplace_back(val);
+					continue;
+				}
+
+				while (j < rhs.size() && rhs[j] < val)
+					++j;
+				if (j == rhs.size())
+					break;
+				if (rhs[j] == val)
+					res.emplace_back(val);
+			}
+
+			return res;
+		}
+
+		void unite(container& dst, container const& src)
+		{
+			if (dst.type == roaring_type::array && src.type == roaring_type::array)
+			{
+				dst.values = merge_union(dst.values, src.values);
+				dst.count = dst.values.size();
+				normalize(dst);
+				return;
+			}
+
+			to_bitmap(dst);
+			switch (src.type)
+			{
+			case roaring_type::array:
+				for (uint32_t i {0}; i < src.values.size(); ++i)
+					dst.words[src.values[i] / 64] |= uint64_t(1) << (src.values[i] % 64);
+				break;
+			case roaring_type::bitmap:
+				__internal::bit_apply(dst.words.data(), src.words.data(),
+				                      container::bitmap_words,
+				                      [](auto lhs, auto rhs) { return lhs | rhs; });
+				break;
+			case roaring_type::run:
+				for (uint32_t i {0}; i < src.values.size(); i += 2)
+				{
+					uint32_t count = src.values[i + 1] - src.values[i] + 1;
+					__internal::bit_fill(dst.words.data(), src.values[i], count, true);
+				}
+				break;
+			}
+
+			recount(dst);
+			normalize(dst);
+		}
+
+		// Keeps the values of arr that other contains.
+		vector<uint16_t> filter(array_view<uint16_t> arr, container const& other)
+		{
+			vector<uint16_t> res;
+			res.reserve(arr.size());
+			for (uint32_t i {0}; i < arr.size(); ++i)
+			{
+				if (contains(other, arr[i]))
+					res.emplace_back(arr[i]);
+			}
+
+			return res;
+		}
+
+		void intersect(container& dst, container const& src)
+		{
+			if (dst.type == roaring_type::array && src.type == roaring_type::array)
+				dst.values = merge_intersection(dst.values, src.values);
+			else if (dst.type == roaring_type::array)
+				dst.values = filter(dst.values, src);
+			else if (src.type == roaring_type::array)
+			{
+				dst.values = filter(src.values, dst);
+				dst.type = roaring_type::array;
+				dst.words = {};
+			}
+			else
+			{
+				to_bitmap(dst);
+				container tmp;
+				container const* other = &src;
+				if (src.type != roaring_type::bitmap)
+				{
+					tmp = src;
+					to_bitmap(tmp);
+					other = &tmp;
+				}
+
+				__internal::bit_apply(dst.words.data(), other->words.data(),
+				                      container::bitmap_words,
+				                      [](auto lhs, auto rhs) { return lhs & rhs; });
+				recount(dst);
+				normalize(dst);
+				return;
+			}
+
+			dst.count = dst.values.size();
+		}
+
+		bool equal(container const& lhs, container const& rhs)
+		{
+			if (lhs.count != rhs.count)
+				return false;
+			// Equal counts can still be split in a different number of runs.
+			if (lhs.type == rhs.type && lhs.values.size() != rhs.values.size())
+				return false;
+			if (lhs.type == rhs.type)
+				return lhs.type == roaring_type::bitmap
+				           ? __builtin_memcmp(lhs.words.data(), rhs.words.data(),
+				                              container::bitmap_words * 8) == 0
+				           : __builtin_memcmp(lhs.values.data(), rhs.values.data(),
+				                              lhs.values.size() * 2) == 0;
+
+			// Different types are compared as bitmaps.
+			container lhs_bits, rhs_bits;
+			container const* lhs_ptr = &lhs;
+			container const* rhs_ptr = &rhs;
+			if (lhs.type != roaring_type::bitmap)
+			{
+				lhs_bits = lhs;
+				to_bitmap(lhs_bits);
+				lhs_ptr = &lhs_bits;
+			}
+			if (rhs.type != roaring_type::bitmap)
+			{
+				rhs_bits = rhs;
+				to_bitmap(rhs_bits);
+				rhs_ptr = &rhs_bits;
+			}
+
+			return __builtin_memcmp(lhs_ptr->words.data(), rhs_ptr->words.data(),
+			                        container::bitmap_words * 8) == 0;
+		}
+	}
+
+	roaring_bitmap::roaring_bitmap(array_view<uint32_t> values)
+	{
+		vector<uint32_t> sorted(values.size());
+		for (uint32_t i {0}; i < values.size(); ++i)
+			sorted[i] = values[i];
+		sort<uint32_t>(sorted);
+
+		// Sorted values are appended to the last container.
+		for (uint32_t i {0}; i < sorted.size(); ++i)
+		{
+			uint32_t val = sorted[i];
+			if (i > 0 && sorted[i - 1] == val)
+				continue;
+
+			uint16_t key = val >> 16;
+			if (keys_.empty() || keys_.back() != key)
+			{
+				keys_.emplace_back(key);
+				containers_.emplace_back();
+			}
+
+			container& cont = containers_.back();
+			if (cont.type == roaring_type::array && cont.count == container::array_max)
+				to_bitmap(cont);
+
+			uint16_t low = val & 0xffff;
+			if (cont.type == roaring_type::array)
+				cont.values.emplace_back(low);
+			else
+				cont.words[low / 64] |= uint64_t(1) << (low % 64);
+			++cont.count;
+		}
+	}
+
+	bool roaring_bitmap::empty() const
+	{
+		return keys_.empty();
+	}
+
+	uint64_t roaring_bitmap::count() const
+	{
+		uint64_t res {0};
+		for (uint32_t i {0}; i < containers_.size(); ++i)
+			res += containers_[i].count;
+
+		return res;
+	}
+
+	uint64_t roaring_bitmap::memory_size() const
+	{
+		uint64_t res {0};
+		for (uint32_t i {0}; i < containers_.size(); ++i)
+			res += byte_size(containers_[i]);
+
+		return res;
+	}
+
+	bool roaring_bitmap::contains(uint32_t val) const
+	{
+		uint16_t key = val >> 16;
+		uint32_t idx = lower_bound<uint16_t>(keys_, key);
+		if (idx == keys_.size() || keys_[idx] != key)
+			return false;
+
+		return mc::contains(containers_[idx], val & 0xffff);
+	}
+
+	roaring_bitmap::container& roaring_bitmap::get(uint16_t key)
+	{
+		uint32_t idx = lower_bound<uint16_t>(keys_, key);
+		if (idx == keys_.size() || keys_[idx] != key)
+		{
+			keys_.insert(idx, key);
+			containers_.insert(idx, container {});
+		}
+
+		return containers_[idx];
+	}
+
+	void roaring_bitmap::add(uint32_t val)
+	{
+		container& cont = get(val >> 16);
+		uint16_t   low = val & 0xffff;
+
+		if (cont.type == roaring_type::run)
+		{
+			if (find_run(cont, low) != UINT32_MAX)
+				return;
+			to_bitmap(cont);
+		}
+
+		if (cont.type == roaring_type::array)
+		{
+			uint32_t idx = lower_bound<uint16_t>(cont.values, low);
+			if (idx < cont.values.size() && cont.values[idx] == low)
+				return;
+
+			cont.values.insert(idx, low);
+			++cont.count;
+		}
+		else
+		{
+			uint64_t& word = cont.words[low / 64];
+			uint64_t  bit = uint64_t(1) << (low % 64);
+			cont.count += (word & bit) == 0;
+			word |= bit;
+		}
+
+		normalize(cont);
+	}
+
+	void roaring_bitmap::add_range(uint32_t first, uint32_t count)
+	{
+		while (count > 0)
+		{
+			uint32_t low = first & 0xffff;
+			uint32_t chunk_count = 65536 - low;
+			if (chunk_count > count)
+				chunk_count = count;
+
+			container& cont = get(first >> 16);
+			if (cont.count == 0)
+			{
+				// A new container is a single run.
+				cont.type = roaring_type::run;
+				cont.values.emplace_back(low);
+				cont.values.emplace_back(low + chunk_count - 1);
+				cont.count = chunk_count;
+			}
+			else
+			{
+				to_bitmap(cont);
+				__internal::bit_fill(cont.words.data(), low, chunk_count, true);
+				recount(cont);
+				normalize(cont);
+			}
+
+			count -= chunk_count;
+			first += chunk_count;
+		}
+	}
+
+	void roaring_bitmap::remove(uint32_t val)
+	{
+		uint16_t key = val >> 16;
+		uint32_t idx = lower_bound<uint16_t>(keys_, key);
+		if (idx == keys_.size() || keys_[idx] != key)
+			return;
+
+		container& cont = containers_[idx];
+		uint16_t   low = val & 0xffff;
+		if (!mc::contains(cont, low))
+			return;
+
+		if (cont.type == roaring_type::array)
+			cont.values.erase(lower_bound<uint16_t>(cont.values, low));
+		else
+		{
+			to_bitmap(cont);
+			cont.words[low / 64] &= ~(uint64_t(1) << (low % 64));
+		}
+		--cont.count;
+
+		if (cont.count == 0)
+		{
+			keys_.erase(idx);
+			containers_.erase(idx);
+		}
+		else
+			normalize(cont);
+	}
+
+	void roaring_bitmap::clear()
+	{
+		keys_.clear();
+		containers_.clear();
+	}
+
+	void roaring_bitmap::optimize()
+	{
+		for (uint32_t i {0}; i < containers_.size(); ++i)
+		{
+			container& cont = containers_[i];
+			uint32_t   run_size = run_count(cont) * 4;
+			// Smallest of array and bitmap, as picked by normalize().
+			uint32_t flat_size = cont.count <= container::array_max
+			                         ? cont.count * 2
+			                         : container::bitmap_words * 8;
+			if (run_size < flat_size)
+				to_run(cont);
+			else if (cont.type == roaring_type::run)
+				normalize(cont);
+		}
+	}
+
+	vector<uint32_t> roaring_bitmap::to_vector() const
+	{
+		vector<uint32_t> res;
+		res.reserve(static_cast<uint32_t>(count()));
+		for_each([&](uint32_t val) { res.emplace_back(val); });
+
+		return res;
+	}
+
+	roaring_bitmap& roaring_bitmap::operator|=(roaring_bitmap const& other)
+	{
+		vector<uint16_t>  keys;
+		vector<container> containers;
+		keys.reserve(keys_.size() + other.keys_.size());
+		containers.reserve(keys_.size() + other.keys_.size());
+
+		uint32_t i {0}, j {0};
+		while (i < keys_.size() || j < other.keys_.size())
+		{
+			bool lhs_only = j == other.keys_.size() ||
+			                (i < keys_.size() && keys_[i] < other.keys_[j]);
+			if (lhs_only)
+			{
+				keys.emplace_back(keys_[i]);
+				containers.emplace_back(move(containers_[i++]));
+			}
+			else if (i == keys_.size() || other.keys_[j] < keys_[i])
+			{
+				keys.emplace_back(other.keys_[j]);
+				containers.emplace_back(other.containers_[j++]);
+			}
+			else
+			{
+				keys.emplace_back(keys_[i]);
+				container& cont = containers.emplace_back(move(containers_[i++]));
+				unite(cont, other.containers_[j++]);
+			}
+		}
+
+		keys_ = move(keys);
+		containers_ = move(containers);
+		return *this;
+	}
+
+	roaring_bitmap& roaring_bitmap::operator&=(roaring_bitmap const& other)
+	{
+		// Matching containers are intersected in place and compacted to the front.
+		uint32_t size {0};
+		uint32_t j {0};
+		for (uint32_t i {0}; i < keys_.size(); ++i)
+		{
+			uint32_t key = keys_[i];
+			while (j < other.keys_.size() && other.keys_[j] < key)
+				++j;
+			if (j == other.keys_.size())
+				break;
+			if (other.keys_[j] != key)
+				continue;
+
+			container& cont = containers_[i];
+			intersect(cont, other.containers_[j]);
+			if (cont.count == 0)
+				continue;
+
+			if (size != i)
+			{
+				keys_[size] = keys_[i];
+				containers_[size] = move(cont);
+			}
+			++size;
+		}
+
+		keys_.erase(size, keys_.size() - size);
+		containers_.erase(size, containers_.size() - size);
+		return *this;
+	}
+
+	bool roaring_bitmap::operator==(roaring_bitmap const& other) const
+	{
+		if (keys_.size() != other.keys_.size())
+			return false;
+
+		for (uint32_t i {0}; i < keys_.size(); ++i)
+		{
+			if (keys_[i] != other.keys_[i])
+				return false;
+			if (!equal(containers_[i], other.containers_[i]))
+				return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+#include "bitset.hh"
+#include "vector.hh"
+
+namespace mc
+{
+	namespace __internal
+	{
+		enum class roaring_type : uint8_t
+		{
+			array,
+			bitmap,
+			run,
+		};
+
+		// Set of the 16 low bits of the values sharing the same 16 high bits.
+		struct roaring_container
+		{
+			// Above this count, bitmaps are smaller than arrays.
+			static constexpr uint32_t array_max = 4096;
+			static constexpr uint32_t bitmap_words = 65536 / 64;
+
+			roaring_type type {roaring_type::array};
+			uint32_t     count {0};
+			// Sorted values for arrays, or first and last values of each run.
+			vector<uint16_t> values;
+			// bitmap_words words for bitmaps.
+			vector<uint64_t> words;
+		};
+	}
+
+	/// @brief Compressed set of uint32_t, after Roaring bitmaps.
+	/// @details Values are split by their 16 high bits in chunks of 65536 values, stored
+	/// in sorted keys and containers vectors. Each container is a sorted uint16_t array
+	/// up to 4096 values, a 8 KB bitmap above, or a list of runs once optimize() finds
+	/// them smaller. Union and intersection of bitmaps work on SIMD registers, arrays
+	/// intersections compare 8 values at a time.
+	/// Operations other than add_range() and optimize() turn run containers back into
+	/// arrays or bitmaps.
+	class roaring_bitmap
+	{
+	public:
+		roaring_bitmap() = default;
+		// values can be in any order and contain duplicates.
+		roaring_bitmap(array_view<uint32_t> values);
+
+		bool     empty() const;
+		uint64_t count() const;
+		// Bytes taken by the values of the containers, without the keys.
+		uint64_t memory_size() const;
+		bool     contains(uint32_t val) const;
+
+		void add(uint32_t val);
+		// Adds count values from first.
+		void add_range(uint32_t first, uint32_t count);
+		void remove(uint32_t val);
+		void clear();
+
+		// Converts containers to runs when they are smaller this way.
+		void optimize();
+
+		// Calls f with each value, in increasing order.
+		template <typename F>
+		void for_each(F f) const;
+		vector<uint32_t> to_vector() const;
+
+		roaring_bitmap& operator|=(roaring_bitmap const& other);
+		roaring_bitmap& operator&=(roaring_bitmap const& other);
+
+		bool operator==(roaring_bitmap const& other) const;
+
+	private:
+		using container = __internal::roaring_container;
+
+		// Container of key, created empty if missing.
+		container& get(uint16_t key);
+
+		vector<uint16_t>  keys_;
+		vector<container> containers_;
+	};
+}
+
+namespace mc
+{
+	template <typename F>
+	void roaring_bitmap::for_each(F f) const
+	{
+		for (uint32_t i {0}; i < keys_.size(); ++i)
+		{
+			uint32_t high = uint32_t(keys_[i]) << 16;
+			container const& cont = containers_[i];
+
+			switch (cont.type)
+			{
+			case __internal::roaring_type::array:
+				for (uint32_t j {0}; j < cont.values.size(); ++j)
+					f(high | cont.values[j]);
+				break;
+			case __internal::roaring_type::bitmap:
+			{
+				auto call = [&](uint32_t low) { f(high | low); };
+				__internal::bit_for_each_set(cont.words.data(), cont.words.size(), call);
+				break;
+			}
+			case __internal::roaring_type::run:
+				for (uint32_t j {0}; j < cont.values.size(); j += 2)
+				{
+					for (uint32_t low = cont.values[j]; low <= cont.values[j + 1]; ++low)
+						f(high | low);
+				}
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,518 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "concepts.hh"
+#include "type_traits.hh"
+
+namespace mc
+{
+	// Size in bytes of the widest vector registers of the target: 64 with AVX-512, 32
+	// with AVX2, 16 otherwise (SSE2, NEON).
+#if defined(__AVX512F__)
+	constexpr uint32_t simd_width = 64;
+#elif defined(__AVX2__)
+	constexpr uint32_t simd_width = 32;
+#else
+	constexpr uint32_t simd_width = 16;
+#endif
+
+	// Bit mask of N lanes, lane i being bit i.
+	template <uint32_t N>
+	using simd_bitmask = conditional_t<(N > 32), uint64_t, uint32_t>;
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	class simd_mask;
+
+	/// @brief Vector of N lanes of T, on top of clang vector extensions.
+	/// @tparam T lane type.
+	/// @tparam N lane count, a power of two.
+	/// @details Operations are lane-wise, and compile to the instructions of the target
+	/// (SSE2, AVX2, NEON...). Vectors larger than the target registers are split by the
+	/// compiler. Kernels should use native_simd<T>, which fills a register.
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	class simd
+	{
+	public:
+		using vector_type = T __attribute__((ext_vector_type(N)));
+
+		static constexpr uint32_t lanes = N;
+
+		simd() = default;
+		// All lanes set to val.
+		simd(T val);
+		simd(vector_type vec);
+
+		static simd load(T const* ptr);
+		// ptr must be aligned on sizeof(simd).
+		static simd load_aligned(T const* ptr);
+		// Loads the count first lanes from ptr, the other ones being set to fill. Never
+		// reads past ptr + count, for the tail of arrays.
+		static simd load_partial(T const* ptr, uint32_t count, T fill = {});
+
+		void store(T* ptr) const;
+		// ptr must be aligned on sizeof(simd).
+		void store_aligned(T* ptr) const;
+		// Stores the count first lanes to ptr.
+		void store_partial(T* ptr, uint32_t count) const;
+
+		vector_type native() const;
+		T           operator[](uint32_t idx) const;
+
+		simd operator+(simd rhs) const;
+		simd operator-(simd rhs) const;
+		simd operator*(simd rhs) const;
+		simd operator/(simd rhs) const;
+
+		simd operator&(simd rhs) const
+			requires integral<T>;
+		simd operator|(simd rhs) const
+			requires integral<T>;
+		simd operator^(simd rhs) const
+			requires integral<T>;
+		simd operator~() const
+			requires integral<T>;
+		simd operator<<(uint32_t shift) const
+			requires integral<T>;
+		simd operator>>(uint32_t shift) const
+			requires integral<T>;
+
+		simd_mask<T, N> operator==(simd rhs) const;
+		simd_mask<T, N> operator!=(simd rhs) const;
+		simd_mask<T, N> operator<(simd rhs) const;
+		simd_mask<T, N> operator<=(simd rhs) const;
+		simd_mask<T, N> operator>(simd rhs) const;
+		simd_mask<T, N> operator>=(simd rhs) const;
+
+		// Lane i of the result is lane Idx[i] of this vector.
+		template <int... Idx>
+			requires(sizeof...(Idx) == N)
+		simd shuffle() const;
+		simd reverse() const;
+
+		T reduce_add() const;
+		T reduce_min() const;
+		T reduce_max() const;
+
+	private:
+		vector_type vec_;
+	};
+
+	/// @brief Result of a lane-wise comparison of simd<T, N>.
+	/// @details Lanes are integers of the size of T, with all bits set when true, as
+	/// produced by the comparison instructions. bitmask() packs them as bits, to find
+	/// matching lanes with bit operations (countr_zero...).
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	class simd_mask
+	{
+	public:
+		using vector_type = decltype(typename simd<T, N>::vector_type {} ==
+		                             typename simd<T, N>::vector_type {});
+
+		simd_mask() = default;
+		simd_mask(vector_type vec);
+
+		vector_type     native() const;
+		simd_bitmask<N> bitmask() const;
+
+		bool any() const;
+		bool all() const;
+		bool none() const;
+
+		simd_mask operator&(simd_mask rhs) const;
+		simd_mask operator|(simd_mask rhs) const;
+		simd_mask operator^(simd_mask rhs) const;
+		simd_mask operator~() const;
+
+	private:
+		vector_type vec_;
+	};
+
+	// simd filling the widest vector registers of the target.
+	template <arithmetic T>
+	using native_simd = simd<T, simd_width / sizeof(T)>;
+
+	// Lane-wise select: lanes of lhs where mask is true, of rhs otherwise.
+	template <arithmetic T, uint32_t N>
+	simd<T, N> select(simd_mask<T, N> mask, simd<T, N> lhs, simd<T, N> rhs);
+	template <arithmetic T, uint32_t N>
+	simd<T, N> min(simd<T, N> lhs, simd<T, N> rhs);
+	template <arithmetic T, uint32_t N>
+	simd<T, N> max(simd<T, N> lhs, simd<T, N> rhs);
+}
+
+namespace mc
+{
+	namespace __internal
+	{
+		template <uint32_t N, typename M>
+		simd_bitmask<N> simd_to_bitmask(M mask)
+		{
+			// Converting to a bool vector is the pattern clang lowers to movemask on x86,
+			// and to a narrowing sequence on NEON.
+			using bool_vector = bool __attribute__((ext_vector_type(N)));
+			using bits = conditional_t<(N > 32), uint64_t,
+			                           conditional_t<(N > 16), uint32_t,
+			                                         conditional_t<(N > 8), uint16_t,
+			                                                       uint8_t>>>;
+
+			simd_bitmask<N> res =
+				__builtin_bit_cast(bits, __builtin_convertvector(mask, bool_vector));
+			if constexpr (N < 8)
+				res &= (1u << N) - 1;
+
+			return res;
+		}
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N>::simd(T val)
+	: vec_ {vector_type {} + val}
+	{}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N>::simd(vector_type vec)
+	: vec_ {vec}
+	{}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::load(T const* ptr)
+	{
+		vector_type vec;
+		__builtin_memcpy(&vec, ptr, sizeof(vec));
+		return vec;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::load_aligned(T const* ptr)
+	{
+		void const* aligned = __builtin_assume_aligned(ptr, sizeof(simd));
+		return *static_cast<vector_type const*>(aligned);
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::load_partial(T const* ptr, uint32_t count, T fill)
+	{
+		T buf[N];
+		for (uint32_t i {0}; i < N; ++i)
+			buf[i] = fill;
+		__builtin_memcpy(buf, ptr, sizeof(T) * count);
+
+		return load(buf);
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	void simd<T, N>::store(T* ptr) const
+	{
+		__builtin_memcpy(ptr, &vec_, sizeof(vec_));
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	void simd<T, N>::store_aligned(T* ptr) const
+	{
+		*static_cast<vector_type*>(__builtin_assume_aligned(ptr, sizeof(simd))) = vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	void simd<T, N>::store_partial(T* ptr, uint32_t count) const
+	{
+		T buf[N];
+		store(buf);
+		__builtin_memcpy(ptr, buf, sizeof(T) * count);
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N>::vector_type simd<T, N>::native() const
+	{
+		return vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	T simd<T, N>::operator[](uint32_t idx) const
+	{
+		return vec_[idx];
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::operator+(simd rhs) const
+	{
+		return vec_ + rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::operator-(simd rhs) const
+	{
+		return vec_ - rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::operator*(simd rhs) const
+	{
+		return vec_ * rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::operator/(simd rhs) const
+	{
+		return vec_ / rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::operator&(simd rhs) const
+		requires integral<T>
+	{
+		return vec_ & rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::operator|(simd rhs) const
+		requires integral<T>
+	{
+		return vec_ | rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::operator^(simd rhs) const
+		requires integral<T>
+	{
+		return vec_ ^ rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::operator~() const
+		requires integral<T>
+	{
+		return ~vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::operator<<(uint32_t shift) const
+		requires integral<T>
+	{
+		return vec_ << static_cast<T>(shift);
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::operator>>(uint32_t shift) const
+		requires integral<T>
+	{
+		return vec_ >> static_cast<T>(shift);
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd_mask<T, N> simd<T, N>::operator==(simd rhs) const
+	{
+		return vec_ == rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd_mask<T, N> simd<T, N>::operator!=(simd rhs) const
+	{
+		return vec_ != rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd_mask<T, N> simd<T, N>::operator<(simd rhs) const
+	{
+		return vec_ < rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd_mask<T, N> simd<T, N>::operator<=(simd rhs) const
+	{
+		return vec_ <= rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd_mask<T, N> simd<T, N>::operator>(simd rhs) const
+	{
+		return vec_ > rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd_mask<T, N> simd<T, N>::operator>=(simd rhs) const
+	{
+		return vec_ >= rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	template <int... Idx>
+		requires(sizeof...(Idx) == N)
+	simd<T, N> simd<T, N>::shuffle() const
+	{
+		return __builtin_shufflevector(vec_, vec_, Idx...);
+	}
+
+	// Lane loops below are recognized by the compiler, and lowered to shuffles and
+	// horizontal operations of the target.
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd<T, N> simd<T, N>::reverse() const
+	{
+		vector_type res;
+		for (uint32_t i {0}; i < N; ++i)
+			res[i] = vec_[N - 1 - i];
+
+		return res;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	T simd<T, N>::reduce_add() const
+	{
+		T res = vec_[0];
+		for (uint32_t i {1}; i < N; ++i)
+			res += vec_[i];
+
+		return res;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	T simd<T, N>::reduce_min() const
+	{
+		T res = vec_[0];
+		for (uint32_t i {1}; i < N; ++i)
+			res = vec_[i] < res ? vec_[i] : res;
+
+		return res;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	T simd<T, N>::reduce_max() const
+	{
+		T res = vec_[0];
+		for (uint32_t i {1}; i < N; ++i)
+			res = res < vec_[i] ? vec_[i] : res;
+
+		return res;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd_mask<T, N>::simd_mask(vector_type vec)
+	: vec_ {vec}
+	{}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd_mask<T, N>::vector_type simd_mask<T, N>::native() const
+	{
+		return vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd_bitmask<N> simd_mask<T, N>::bitmask() const
+	{
+		return __internal::simd_to_bitmask<N>(vec_);
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	bool simd_mask<T, N>::any() const
+	{
+		return bitmask() != 0;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	bool simd_mask<T, N>::all() const
+	{
+		// Shifting right keeps the shift count below the width of the bitmask.
+		constexpr simd_bitmask<N> full =
+			simd_bitmask<N>(~simd_bitmask<N>(0)) >> (sizeof(simd_bitmask<N>) * 8 - N);
+		return bitmask() == full;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	bool simd_mask<T, N>::none() const
+	{
+		return bitmask() == 0;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd_mask<T, N> simd_mask<T, N>::operator&(simd_mask rhs) const
+	{
+		return vec_ & rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd_mask<T, N> simd_mask<T, N>::operator|(simd_mask rhs) const
+	{
+		return vec_ | rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd_mask<T, N> simd_mask<T, N>::operator^(simd_mask rhs) const
+	{
+		return vec_ ^ rhs.vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+		requires(N >= 2 && N <= 64 && (N & (N - 1)) == 0)
+	simd_mask<T, N> simd_mask<T, N>::operator~() const
+	{
+		return ~vec_;
+	}
+
+	template <arithmetic T, uint32_t N>
+	simd<T, N> select(simd_mask<T, N> mask, simd<T, N> lhs, simd<T, N> rhs)
+	{
+		// Bitwise select, so it works for floating point lanes too.
+		using bits = simd_mask<T, N>::vector_type;
+
+		bits m = mask.native();
+		bits l = __builtin_bit_cast(bits, lhs.native());
+		bits r = __builtin_bit_cast(bits, rhs.native());
+		return __builtin_bit_cast(typename simd<T, N>::vector_type, (l & m) | (r & ~m));
+	}
+
+	template <arithmetic T, uint32_t N>
+	simd<T, N> min(simd<T, N> lhs, simd<T, N> rhs)
+	{
+		return select(lhs < rhs, lhs, rhs);
+	}
+
+	template <arithmetic T, uint32_t N>
+	simd<T, N> max(simd<T, N> lhs, simd<T, N> rhs)
+	{
+		return select(rhs < lhs, lhs, rhs);
+	}
+}
@@ -0,0 +1,400 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+#include "bit.hh"
+#include "functional.hh"
+#include "span.hh"
+#include "utility.hh"
+#include "vector.hh"
+
+namespace mc
+{
+	// Sorting and selection algorithms. They work in place on a span, and order
+	// elements following Compare (less<T> by default, meaning ascending order).
+
+	/// @brief Introsort: quicksort with median of three pivots, falling back to heap
+	/// sort when the recursion gets too deep, and to insertion sort on small ranges.
+	template <typename T, typename Compare = less<T>>
+	void sort(span<T> arr, Compare comp = {});
+
+	/// @brief Quickselect: reorders arr so that arr[n] is the element which would be
+	/// there if arr was sorted, every element before it is not greater, and every
+	/// element after it is not less. O(size) on average, without sorting anything.
+	template <typename T, typename Compare = less<T>>
+	void nth_element(span<T> arr, uint32_t n, Compare comp = {});
+
+	/// @brief Sorts the k first elements in the order of the whole array. The other
+	/// elements are left in an unspecified order. O(size * log(k)).
+	template <typename T, typename Compare = less<T>>
+	void partial_sort(span<T> arr, uint32_t k, Compare comp = {});
+
+	/// @brief Copies the k first elements of arr in Compare order (the k smallest ones
+	/// with less<T>, the k largest ones with greater<T>), sorted. arr isn't modified,
+	/// and only k elements are stored at any time.
+	template <typename T, typename Compare = less<T>>
+	vector<T> top_k(array_view<T> arr, uint32_t k, Compare comp = {});
+
+	/// @brief Streaming version of top_k: keeps the k first elements in Compare order
+	/// of everything pushed so far, in a bounded binary heap.
+	/// @details The heap root is the worst kept element, so rejecting an element (the
+	/// common case when k is small compared to the stream) costs a single comparison.
+	template <typename T, typename Compare = less<T>>
+	class top_k_accumulator
+	{
+	public:
+		top_k_accumulator(uint32_t k, Compare comp = {});
+
+		bool     empty() const;
+		uint32_t size() const;
+		uint32_t max_size() const;
+
+		// Worst kept element, that any new element must beat to be kept once the
+		// accumulator is full.
+		T const& threshold() const;
+
+		// Kept elements, in heap order.
+		array_view<T> values() const&;
+		// Kept elements, sorted.
+		vector<T> sorted() const;
+
+		// Returns true if val was kept.
+		bool push(T const& val);
+		bool push(T&& val);
+
+		void clear();
+
+	private:
+		vector<T> heap_;
+		uint32_t  k_;
+
+		[[no_unique_address]] Compare comp_;
+	};
+}
+
+namespace mc
+{
+	namespace __internal
+	{
+		// Below this size, insertion sort is faster than partitioning.
+		constexpr uint32_t sort_threshold = 16;
+
+		template <typename T, typename Compare>
+		void insertion_sort(T* arr, uint32_t size, Compare& comp)
+		{
+			for (uint32_t i {1}; i < size; ++i)
+			{
+				T        val = move(arr[i]);
+				uint32_t j = i;
+				for (; j > 0 && comp(val, arr[j - 1]); --j)
+					arr[j] = move(arr[j - 1]);
+
+				arr[j] = move(val);
+			}
+		}
+
+		// Binary heap where no element is ordered before its children by comp.
+		template <typename T, typename Compare>
+		void sift_down(T* heap, uint32_t size, uint32_t idx, Compare& comp)
+		{
+			T val = move(heap[idx]);
+			while (true)
+			{
+				uint32_t child = 2 * idx + 1;
+				if (child >= size)
+					break;
+
+				if (child + 1 < size && comp(heap[child], heap[child + 1]))
+					++child;
+
+				if (!comp(val, heap[child]))
+					break;
+
+				heap[idx] = move(heap[child]);
+				idx = child;
+			}
+
+			heap[idx] = move(val);
+		}
+
+		template <typename T, typename Compare>
+		void sift_up(T* heap, uint32_t idx, Compare& comp)
+		{
+			T val = move(heap[idx]);
+			while (idx > 0)
+			{
+				uint32_t parent = (idx - 1) / 2;
+				if (!comp(heap[parent], val))
+					break;
+
+				heap[idx] = move(heap[parent]);
+				idx = parent;
+			}
+
+			heap[idx] = move(val);
+		}
+
+		template <typename T, typename Compare>
+		void make_heap(T* heap, uint32_t size, Compare& comp)
+		{
+			for (uint32_t i {size / 2}; i > 0; --i)
+				sift_down(heap, size, i - 1, comp);
+		}
+
+		template <typename T, typename Compare>
+		void sort_heap(T* heap, uint32_t size, Compare& comp)
+		{
+			for (uint32_t i {size}; i > 1; --i)
+			{
+				swap(heap[0], heap[i - 1]);
+				sift_down(heap, i - 1, 0, comp);
+			}
+		}
+
+		// Hoare partition around the median of the first, middle and last elements.
+		// Returns the final pivot position. size must be at least 3.
+		template <typename T, typename Compare>
+		uint32_t partition(T* arr, uint32_t size, Compare& comp)
+		{
+			uint32_t mid = size / 2;
+			if (comp(arr[mid], arr[0]))
+				swap(arr[mid], arr[0]);
+			if (comp(arr[size - 1], arr[mid]))
+			{
+				swap(arr[size - 1], arr[mid]);
+				if (comp(arr[mid], arr[0]))
+					swap(arr[mid], arr[0]);
+			}
+
+			// The pivot is kept at arr[0] during the partition, and the last element
+			// being not less than it acts as a sentinel for the first scan.
+			swap(arr[0], arr[mid]);
+			uint32_t i {0};
+			uint32_t j {size};
+			while (true)
+			{
+				do
+					++i;
+				while (comp(arr[i], arr[0]));
+
+				do
+					--j;
+				while (comp(arr[0], arr[j]));
+
+				if (i >= j)
+					break;
+
+				swap(arr[i], arr[j]);
+			}
+
+			swap(arr[0], arr[j]);
+			return j;
+		}
+
+		inline uint32_t sort_depth_limit(uint32_t size)
+		{
+			return 2 * (bit_width(size) - 1);
+		}
+
+		template <typename T, typename Compare>
+		void intro_sort(T* arr, uint32_t size, uint32_t depth, Compare& comp)
+		{
+			while (size > sort_threshold)
+			{
+				if (depth == 0)
+				{
+					make_heap(arr, size, comp);
+					sort_heap(arr, size, comp);
+					return;
+				}
+				--depth;
+
+				// Recurse on the smallest side to bound the stack usage.
+				uint32_t pivot = partition(arr, size, comp);
+				if (pivot < size - pivot - 1)
+				{
+					intro_sort(arr, pivot, depth, comp);
+					arr += pivot + 1;
+					size -= pivot + 1;
+				}
+				else
+				{
+					intro_sort(arr + pivot + 1, size - pivot - 1, depth, comp);
+					size = pivot;
+				}
+			}
+
+			insertion_sort(arr, size, comp);
+		}
+	}
+
+	template <typename T, typename Compare>
+	void sort(span<T> arr, Compare comp)
+	{
+		if (arr.size() < 2)
+			return;
+
+		uint32_t depth = __internal::sort_depth_limit(arr.size());
+		__internal::intro_sort(arr.data(), arr.size(), depth, comp);
+	}
+
+	template <typename T, typename Compare>
+	void nth_element(span<T> arr, uint32_t n, Compare comp)
+	{
+		T*       ptr = arr.data();
+		uint32_t size = arr.size();
+		if (n >= size)
+			return;
+
+		uint32_t depth = __internal::sort_depth_limit(size);
+		while (size > __internal::sort_threshold)
+		{
+			if (depth == 0)
+			{
+				// Too many bad pivots, fallback on heap selection to stay in
+				// O(size * log(size)).
+				partial_sort(span<T>(ptr, size), n + 1, comp);
+				return;
+			}
+			--depth;
+
+			uint32_t pivot = __internal::partition(ptr, size, comp);
+			if (pivot == n)
+				return;
+
+			if (n < pivot)
+				size = pivot;
+			else
+			{
+				ptr += pivot + 1;
+				size -= pivot + 1;
+				n -= pivot + 1;
+			}
+		}
+
+		__internal::insertion_sort(ptr, size, comp);
+	}
+
+	template <typename T, typename Compare>
+	void partial_sort(span<T> arr, uint32_t k, Compare comp)
+	{
+		if (k > arr.size())
+			k = arr.size();
+		if (k == 0)
+			return;
+
+		// Heap selection: the heap root is the worst of the k best elements so far.
+		__internal::make_heap(arr.data(), k, comp);
+		for (uint32_t i {k}; i < arr.size(); ++i)
+		{
+			if (comp(arr[i], arr[0]))
+			{
+				swap(arr[i], arr[0]);
+				__internal::sift_down(arr.data(), k, 0, comp);
+			}
+		}
+
+		__internal::sort_heap(arr.data(), k, comp);
+	}
+
+	template <typename T, typename Compare>
+	vector<T> top_k(array_view<T> arr, uint32_t k, Compare comp)
+	{
+		top_k_accumulator<T, Compare> acc(k, comp);
+		for (uint32_t i {0}; i < arr.size(); ++i)
+			acc.push(arr[i]);
+
+		return acc.sorted();
+	}
+
+	template <typename T, typename Compare>
+	top_k_accumulator<T, Compare>::top_k_accumulator(uint32_t k, Compare comp)
+	: k_ {k}
+	, comp_ {comp}
+	{
+		heap_.reserve(k);
+	}
+
+	template <typename T, typename Compare>
+	bool top_k_accumulator<T, Compare>::empty() const
+	{
+		return heap_.empty();
+	}
+
+	template <typename T, typename Compare>
+	uint32_t top_k_accumulator<T, Compare>::size() const
+	{
+		return heap_.size();
+	}
+
+	template <typename T, typename Compare>
+	uint32_t top_k_accumulator<T, Compare>::max_size() const
+	{
+		return k_;
+	}
+
+	template <typename T, typename Compare>
+	T const& top_k_accumulator<T, Compare>::threshold() const
+	{
+		return heap_[0];
+	}
+
+	template <typename T, typename Compare>
+	array_view<T> top_k_accumulator<T, Compare>::values() const&
+	{
+		return heap_;
+	}
+
+	template <typename T, typename Compare>
+	vector<T> top_k_accumulator<T, Compare>::sorted() const
+	{
+		vector<T> res(heap_);
+		Compare   comp(comp_);
+		__internal::sort_heap(res.data(), res.size(), comp);
+
+		return res;
+	}
+
+	template <typename T, typename Compare>
+	bool top_k_accumulator<T, Compare>::push(T const& val)
+	{
+		if (heap_.size() < k_)
+		{
+			heap_.emplace_back(val);
+			__internal::sift_up(heap_.data(), heap_.size() - 1, comp_);
+			return true;
+		}
+
+		if (k_ == 0 || !comp_(val, heap_[0]))
+			return false;
+
+		heap_[0] = val;
+		__internal::sift_down(heap_.data(), heap_.size(), 0, comp_);
+		return true;
+	}
+
+	template <typename T, typename Compare>
+	bool top_k_accumulator<T, Compare>::push(T&& val)
+	{
+		if (heap_.size() < k_)
+		{
+			heap_.emplace_back(move(val));
+			__internal::sift_up(heap_.data(), heap_.size() - 1, comp_);
+			return true;
+		}
+
+		if (k_ == 0 || !comp_(val, heap_[0]))
+			return false;
+
+		heap_[0] = move(val);
+		__internal::sift_down(heap_.data(), heap_.size(), 0, comp_);
+		return true;
+	}
+
+	template <typename T, typename Compare>
+	void top_k_accumulator<T, Compare>::clear()
+	{
+		heap_.clear();
+	}
+}
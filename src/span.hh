@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+
+namespace mc
+{
+	/// @brief Mutable array view, not owning the data. Can work for C arrays, array<T>
+	/// as well as vector<T>.
+	/// @tparam T element type.
+	/// @details Same layout as array_view<T>, to which it converts for free. Meant as
+	/// the parameter type of in-place algorithms, where array_view<T> is the one of
+	/// read-only algorithms.
+	template <typename T>
+	class span
+	{
+	public:
+		constexpr span() = default;
+		constexpr span(nullptr_t) = delete;
+		constexpr span(nullptr_t, uint32_t) = delete;
+
+		template <uint32_t S>
+		constexpr span(T (&arr)[S]);
+		constexpr span(T* data, uint32_t size);
+
+		constexpr bool     empty() const;
+		constexpr uint32_t size() const;
+		constexpr T*       data() const;
+
+		constexpr operator array_view<T>() const;
+
+		constexpr T& operator[](uint32_t idx) const;
+		constexpr T& front() const;
+		constexpr T& back() const;
+
+		constexpr span<T> subarr(uint32_t idx, uint32_t size) const;
+
+	private:
+		T*       arr_ {nullptr};
+		uint32_t size_ {0};
+	};
+}
+
+namespace mc
+{
+	template <typename T>
+	template <uint32_t S>
+	constexpr span<T>::span(T (&arr)[S])
+	: arr_ {arr}
+	, size_ {S}
+	{}
+
+	template <typename T>
+	constexpr span<T>::span(T* data, uint32_t size)
+	: arr_ {data}
+	, size_ {size}
+	{}
+
+	template <typename T>
+	constexpr bool span<T>::empty() const
+	{
+		return size_ == 0;
+	}
+
+	template <typename T>
+	constexpr uint32_t span<T>::size() const
+	{
+		return size_;
+	}
+
+	template <typename T>
+	constexpr T* span<T>::data() const
+	{
+		return arr_;
+	}
+
+	template <typename T>
+	constexpr span<T>::operator array_view<T>() const
+	{
+		return {arr_, size_};
+	}
+
+	template <typename T>
+	constexpr T& span<T>::operator[](uint32_t idx) const
+	{
+		return arr_[idx];
+	}
+
+	template <typename T>
+	constexpr T& span<T>::front() const
+	{
+		return arr_[0];
+	}
+
+	template <typename T>
+	constexpr T& span<T>::back() const
+	{
+		return arr_[size_ - 1];
+	}
+
+	template <typename T>
+	constexpr span<T> span<T>::subarr(uint32_t idx, uint32_t size) const
+	{
+		return {arr_ + idx, size};
+	}
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "span.hh"
+
+namespace mc
+{
+	/// @brief View over every stride-th element of contiguous memory, not owning the
+	/// data. Typically a column of a matrix (see md_view).
+	/// @tparam T element type. Elements are mutable unless T is const.
+	/// @details The stride is counted in elements. A stride of 1 makes the view
+	/// contiguous, which algorithms can check to use a span instead.
+	template <typename T>
+	class strided_view
+	{
+	public:
+		constexpr strided_view() = default;
+		constexpr strided_view(nullptr_t, uint32_t, uint32_t) = delete;
+
+		constexpr strided_view(T* data, uint32_t size, uint32_t stride);
+		constexpr strided_view(span<T> sp);
+
+		constexpr bool     empty() const;
+		constexpr uint32_t size() const;
+		constexpr uint32_t stride() const;
+		constexpr T*       data() const;
+
+		// True if elements are adjacent in memory, that is if the stride is 1.
+		constexpr bool contiguous() const;
+
+		constexpr T& operator[](uint32_t idx) const;
+		constexpr T& front() const;
+		constexpr T& back() const;
+
+		constexpr strided_view<T> subarr(uint32_t idx, uint32_t size) const;
+		// View over one element out of step of this view. A step of 0 is taken as 1.
+		constexpr strided_view<T> every(uint32_t step) const;
+
+	private:
+		T*       arr_ {nullptr};
+		uint32_t size_ {0};
+		uint32_t stride_ {1};
+	};
+}
+
+namespace mc
+{
+	template <typename T>
+	constexpr strided_view<T>::strided_view(T* data, uint32_t size, uint32_t stride)
+	: arr_ {data}
+	, size_ {size}
+	, stride_ {stride}
+	{}
+
+	template <typename T>
+	constexpr strided_view<T>::strided_view(span<T> sp)
+	: arr_ {sp.data()}
+	, size_ {sp.size()}
+	, stride_ {1}
+	{}
+
+	template <typename T>
+	constexpr bool strided_view<T>::empty() const
+	{
+		return size_ == 0;
+	}
+
+	template <typename T>
+	constexpr uint32_t strided_view<T>::size() const
+	{
+		return size_;
+	}
+
+	template <typename T>
+	constexpr uint32_t strided_view<T>::stride() const
+	{
+		return stride_;
+	}
+
+	template <typename T>
+	constexpr T* strided_view<T>::data() const
+	{
+		return arr_;
+	}
+
+	template <typename T>
+	constexpr bool strided_view<T>::contiguous() const
+	{
+		return stride_ == 1;
+	}
+
+	template <typename T>
+	constexpr T& strided_view<T>::operator[](uint32_t idx) const
+	{
+		return arr_[idx * stride_];
+	}
+
+	template <typename T>
+	constexpr T& strided_view<T>::front() const
+	{
+		return arr_[0];
+	}
+
+	template <typename T>
+	constexpr T& strided_view<T>::back() const
+	{
+		return arr_[(size_ - 1) * stride_];
+	}
+
+	template <typename T>
+	constexpr strided_view<T> strided_view<T>::subarr(uint32_t idx, uint32_t size) const
+	{
+		return {arr_ + idx * stride_, size, stride_};
+	}
+
+	template <typename T>
+	constexpr strided_view<T> strided_view<T>::every(uint32_t step) const
+	{
+		if (step == 0)
+			step = 1;
+
+		return {arr_, (size_ + step - 1) / step, stride_ * step};
+	}
+}
@@ -1,166 +1,200 @@
 #include "string.hh"
 
 #include "alloc.hh"
+#include "string_search.hh"
 
 #include <string.h>
 
 namespace mc
 {
-#define SIZE(str) ((str).len_ & ~is_large_flag)
-#define DATA(str)                                                                        \
-	(((str).len_ & is_large_flag) == 0 ? (str).small_.str_ : (str).large_.str_)
+#ifdef STRING_COMPACT
+#define SMALL_TAG(str) static_cast<uint8_t>((str).small_.str_[small_size - 1])
+#define IS_LARGE(str) ((SMALL_TAG(str) & large_tag) != 0)
+#define SIZE(str) (IS_LARGE(str) ? (str).large_.len_ : small_size - 1 - SMALL_TAG(str))
+#define SET_SMALL_SIZE(str, size)                                                        \
+	((str).small_.str_[small_size - 1] = static_cast<char>(small_size - 1 - (size)))
+#define SET_LARGE_SIZE(str, size)                                                        \
+	((str).large_.len_ = (size), (str).small_.str_[small_size - 1] = large_tag)
+#else
 #define IS_LARGE(str) (((str).len_ & is_large_flag) != 0)
+#define SIZE(str) ((str).len_ & ~is_large_flag)
+#define SET_SMALL_SIZE(str, size) ((str).len_ = (size))
+#define SET_LARGE_SIZE(str, size) ((str).len_ = (size) | is_large_flag)
+#endif
+#define DATA(str) (IS_LARGE(str) ? (str).large_.str_ : (str).small_.str_)
+// Sets the size while keeping the current layout.
+#define SET_SIZE(str, size)                                                              \
+	(IS_LARGE(str) ? (void)SET_LARGE_SIZE(str, size) : (void)SET_SMALL_SIZE(str, size))
 
 	// The user-defined ctor is needed because clang and gcc (< 13) misunderstand the
 	// union not being trivially constructible.
 	// See https://github.com/llvm/llvm-project/pull/82407 for the clang fix.
 	string::string()
 	: small_ {0}
-	{}
+	{
+		SET_SMALL_SIZE(*this, 0);
+	}
 
 	string::string(uint32_t count, char c)
-	: len_ {count & ~is_large_flag}
 	{
-		if (len_ < small_size)
+		uint32_t len = count & ~is_large_flag;
+
+		if (len < small_size)
 		{
-			memset(small_.str_, c, len_);
-			small_.str_[len_] = '\0';
+			memset(small_.str_, c, len);
+			small_.str_[len] = '\0';
+			SET_SMALL_SIZE(*this, len);
 		}
 		else
 		{
-			large_.str_ = reinterpret_cast<char*>(alloc(len_ + 1, alignof(char)));
-			large_.cap_ = len_;
-			memset(large_.str_, c, len_);
-			large_.str_[len_] = '\0';
-			len_ |= is_large_flag;
+			large_.str_ = reinterpret_cast<char*>(alloc(len + 1, alignof(char)));
+			large_.cap_ = len;
+			memset(large_.str_, c, len);
+			large_.str_[len] = '\0';
+			SET_LARGE_SIZE(*this, len);
 		}
 	}
 
 	string::string(char const* str, uint32_t count)
 	{
+		uint32_t len;
 		if (count == UINT32_MAX)
-			len_ = strlen(str);
+			len = strlen(str);
 		else
-			len_ = count;
+			len = count;
 
-		len_ &= ~is_large_flag;
+		len &= ~is_large_flag;
 
-		if (len_ < small_size)
+		if (len < small_size)
 		{
-			memcpy(small_.str_, str, len_);
-			small_.str_[len_] = '\0';
+			memcpy(small_.str_, str, len);
+			small_.str_[len] = '\0';
+			SET_SMALL_SIZE(*this, len);
 		}
 		else
 		{
-			large_.str_ = reinterpret_cast<char*>(alloc(len_ + 1, alignof(char)));
-			large_.cap_ = len_;
+			large_.str_ = reinterpret_cast<char*>(alloc(len + 1, alignof(char)));
+			large_.cap_ = len;
 
-			memcpy(large_.str_, str, len_);
-			large_.str_[len_] = '\0';
-			len_ |= is_large_flag;
+			memcpy(large_.str_, str, len);
+			large_.str_[len] = '\0';
+			SET_LARGE_SIZE(*this, len);
 		}
 	}
 
 	string::string(string_view str, uint32_t pos, uint32_t count)
 	{
+		uint32_t len;
 		if (count == UINT32_MAX)
-			len_ = str.size() - pos;
+			len = str.size() - pos;
 		else
-			len_ = count;
+			len = count;
 
-		len_ &= ~is_large_flag;
+		len &= ~is_large_flag;
 
-		if (len_ < small_size)
+		if (len < small_size)
 		{
-			memcpy(small_.str_, str.data() + pos, len_);
-			small_.str_[len_] = '\0';
+			memcpy(small_.str_, str.data() + pos, len);
+			small_.str_[len] = '\0';
+			SET_SMALL_SIZE(*this, len);
 		}
 		else
 		{
-			large_.str_ = reinterpret_cast<char*>(alloc(len_ + 1, alignof(char)));
-			large_.cap_ = len_;
+			large_.str_ = reinterpret_cast<char*>(alloc(len + 1, alignof(char)));
+			large_.cap_ = len;
 
-			memcpy(large_.str_, str.data() + pos, len_);
-			large_.str_[len_] = '\0';
-			len_ |= is_large_flag;
+			memcpy(large_.str_, str.data() + pos, len);
+			large_.str_[len] = '\0';
+			SET_LARGE_SIZE(*this, len);
 		}
 	}
 
 	string::string(string const& str, uint32_t pos, uint32_t count)
 	{
+		uint32_t len;
 		if (count == UINT32_MAX)
-			len_ = SIZE(str) - pos;
+			len = SIZE(str) - pos;
 		else
-			len_ = count;
+			len = count;
 
-		len_ &= ~is_large_flag;
+		len &= ~is_large_flag;
 
 		if (IS_LARGE(str))
 		{
-			if (len_ < small_size)
+			if (len < small_size)
 			{
-				memcpy(small_.str_, str.large_.str_ + pos, len_);
-				small_.str_[len_] = '\0';
+				memcpy(small_.str_, str.large_.str_ + pos, len);
+				small_.str_[len] = '\0';
+				SET_SMALL_SIZE(*this, len);
 			}
 			else
 			{
-				large_.str_ = reinterpret_cast<char*>(alloc(len_ + 1, alignof(char)));
-				large_.cap_ = len_;
+				large_.str_ = reinterpret_cast<char*>(alloc(len + 1, alignof(char)));
+				large_.cap_ = len;
 
-				memcpy(large_.str_, str.large_.str_ + pos, len_);
-				large_.str_[len_] = '\0';
-				len_ |= is_large_flag;
+				memcpy(large_.str_, str.large_.str_ + pos, len);
+				large_.str_[len] = '\0';
+				SET_LARGE_SIZE(*this, len);
 			}
 		}
 		else
 		{
-			memcpy(small_.str_, str.small_.str_, len_);
-			small_.str_[len_] = '\0';
+			memcpy(small_.str_, str.small_.str_ + pos, len);
+			small_.str_[len] = '\0';
+			SET_SMALL_SIZE(*this, len);
 		}
 	}
 
 	string::string(string&& str, uint32_t pos, uint32_t count)
 	{
+		uint32_t len;
 		if (count == UINT32_MAX)
-			len_ = SIZE(str) - pos;
+			len = SIZE(str) - pos;
 		else
-			len_ = count;
+			len = count;
 
-		len_ = SIZE(*this) | (str.len_ & is_large_flag);
-		if (IS_LARGE(*this))
+		len &= ~is_large_flag;
+
+		if (IS_LARGE(str))
 		{
 			large_ = str.large_;
-			memmove(large_.str_, large_.str_ + pos, SIZE(*this));
-			large_.str_[SIZE(*this)] = '\0';
+			memmove(large_.str_, large_.str_ + pos, len);
+			large_.str_[len] = '\0';
+			SET_LARGE_SIZE(*this, len);
+
 			str.large_.str_ = nullptr;
 			str.large_.cap_ = 0;
 		}
 		else
 		{
 			small_ = str.small_;
-			memmove(small_.str_, small_.str_ + pos, SIZE(*this));
-			small_.str_[len_] = '\0';
+			memmove(small_.str_, small_.str_ + pos, len);
+			small_.str_[len] = '\0';
+			SET_SMALL_SIZE(*this, len);
 		}
 
-		str.len_ = 0;
+		str.small_.str_[0] = '\0';
+		SET_SMALL_SIZE(str, 0);
 	}
 
 	string::string(std::initializer_list<char> ilist)
-	: len_ {static_cast<uint32_t>(ilist.size())}
 	{
-		if (len_ < small_size)
+		uint32_t len = static_cast<uint32_t>(ilist.size());
+
+		if (len < small_size)
 		{
-			memcpy(small_.str_, ilist.begin(), len_);
-			small_.str_[len_] = '\0';
+			memcpy(small_.str_, ilist.begin(), len);
+			small_.str_[len] = '\0';
+			SET_SMALL_SIZE(*this, len);
 		}
 		else
 		{
-			large_.str_ = reinterpret_cast<char*>(alloc(len_ + 1, alignof(char)));
-			large_.cap_ = len_;
+			large_.str_ = reinterpret_cast<char*>(alloc(len + 1, alignof(char)));
+			large_.cap_ = len;
 
-			memcpy(large_.str_, ilist.begin(), len_);
-			large_.str_[len_] = '\0';
-			len_ |= is_large_flag;
+			memcpy(large_.str_, ilist.begin(), len);
+			large_.str_[len] = '\0';
+			SET_LARGE_SIZE(*this, len);
 		}
 	}
 
@@ -237,7 +271,7 @@ namespace mc
 		else
 			small_.str_[0] = '\0';
 
-		len_ = 0 | (len_ & is_large_flag);
+		SET_SIZE(*this, 0);
 	}
 
 	void string::reserve(uint32_t cap)
@@ -257,12 +291,11 @@ namespace mc
 			{
 				char* new_str = reinterpret_cast<char*>(alloc(cap + 1, alignof(char)));
 				memcpy(new_str, small_.str_, SIZE(*this) + 1);
-				free(large_.str_, large_.cap_ + 1, alignof(char));
 
 				large_.str_ = new_str;
 				large_.cap_ = cap;
 
-				len_ |= is_large_flag;
+				SET_LARGE_SIZE(*this, SIZE(*this));
 			}
 		}
 	}
@@ -315,7 +348,7 @@ namespace mc
 					large_.str_[size] = '\0';
 				}
 
-				len_ = size | is_large_flag;
+				SET_LARGE_SIZE(*this, size);
 			}
 			else if (size >= small_size)
 			{
@@ -328,26 +361,26 @@ namespace mc
 				large_.str_ = new_str;
 				large_.cap_ = size;
 
-				len_ = size | is_large_flag;
+				SET_LARGE_SIZE(*this, size);
 			}
 			else
 			{
 				memset(small_.str_ + SIZE(*this), c, size - SIZE(*this));
 				small_.str_[size] = '\0';
 
-				len_ = size;
+				SET_SMALL_SIZE(*this, size);
 			}
 		}
 		else if (IS_LARGE(*this))
 		{
 			large_.str_[size] = '\0';
 
-			len_ = size | (len_ & is_large_flag);
+			SET_SIZE(*this, size);
 		}
 		else
 		{
 			small_.str_[size] = '\0';
-			len_ = size;
+			SET_SMALL_SIZE(*this, size);
 		}
 	}
 
@@ -372,7 +405,7 @@ namespace mc
 			}
 			memset(large_.str_, c, count);
 			large_.str_[count] = '\0';
-			len_ = count | is_large_flag;
+			SET_LARGE_SIZE(*this, count);
 		}
 		else if (count >= small_size)
 		{
@@ -382,13 +415,13 @@ namespace mc
 			large_.str_ = new_str;
 			memset(large_.str_, c, count);
 			large_.str_[count] = '\0';
-			len_ = count | is_large_flag;
+			SET_LARGE_SIZE(*this, count);
 		}
 		else
 		{
 			memset(small_.str_, c, count);
 			small_.str_[count] = '\0';
-			len_ = count;
+			SET_SMALL_SIZE(*this, count);
 		}
 	}
 
@@ -416,7 +449,7 @@ namespace mc
 			}
 			memcpy(large_.str_, str, count);
 			large_.str_[count] = '\0';
-			len_ = count | is_large_flag;
+			SET_LARGE_SIZE(*this, count);
 		}
 		else if (count >= small_size)
 		{
@@ -426,13 +459,13 @@ namespace mc
 			large_.str_ = new_str;
 			memcpy(large_.str_, str, count);
 			large_.str_[count] = '\0';
-			len_ = count | is_large_flag;
+			SET_LARGE_SIZE(*this, count);
 		}
 		else
 		{
 			memcpy(small_.str_, str, count);
 			small_.str_[count] = '\0';
-			len_ = count;
+			SET_SMALL_SIZE(*this, count);
 		}
 	}
 
@@ -460,7 +493,7 @@ namespace mc
 			}
 			memcpy(large_.str_, str.data() + pos, count);
 			large_.str_[count] = '\0';
-			len_ = count | is_large_flag;
+			SET_LARGE_SIZE(*this, count);
 		}
 		else if (count >= small_size)
 		{
@@ -470,13 +503,13 @@ namespace mc
 			large_.str_ = new_str;
 			memcpy(large_.str_, str.data() + pos, count);
 			large_.str_[count] = '\0';
-			len_ = count | is_large_flag;
+			SET_LARGE_SIZE(*this, count);
 		}
 		else
 		{
 			memcpy(small_.str_, str.data() + pos, count);
 			small_.str_[count] = '\0';
-			len_ = count;
+			SET_SMALL_SIZE(*this, count);
 		}
 	}
 
@@ -504,7 +537,7 @@ namespace mc
 			}
 			memcpy(large_.str_, DATA(str) + pos, count);
 			large_.str_[count] = '\0';
-			len_ = count | is_large_flag;
+			SET_LARGE_SIZE(*this, count);
 		}
 		else if (count >= small_size)
 		{
@@ -514,13 +547,13 @@ namespace mc
 			large_.str_ = new_str;
 			memcpy(large_.str_, DATA(str) + pos, count);
 			large_.str_[count] = '\0';
-			len_ = count | is_large_flag;
+			SET_LARGE_SIZE(*this, count);
 		}
 		else
 		{
 			memcpy(small_.str_, DATA(str) + pos, count);
 			small_.str_[count] = '\0';
-			len_ = count;
+			SET_SMALL_SIZE(*this, count);
 		}
 	}
 
@@ -545,7 +578,7 @@ namespace mc
 			}
 			memcpy(large_.str_, ilist.begin(), str_len);
 			large_.str_[str_len] = '\0';
-			len_ = str_len | is_large_flag;
+			SET_LARGE_SIZE(*this, str_len);
 		}
 		else if (str_len >= small_size)
 		{
@@ -555,13 +588,13 @@ namespace mc
 			large_.str_ = new_str;
 			memcpy(large_.str_, ilist.begin(), str_len);
 			large_.str_[str_len] = '\0';
-			len_ = str_len | is_large_flag;
+			SET_LARGE_SIZE(*this, str_len);
 		}
 		else
 		{
 			memcpy(small_.str_, ilist.begin(), str_len);
 			small_.str_[str_len] = '\0';
-			len_ = str_len;
+			SET_SMALL_SIZE(*this, str_len);
 		}
 	}
 
@@ -570,18 +603,23 @@ namespace mc
 		if (IS_LARGE(*this))
 			free(large_.str_, large_.cap_ + 1, alignof(char));
 
-		len_ = str.len_;
-		if (IS_LARGE(*this))
+		if (IS_LARGE(str))
 		{
 			large_.str_ = str.large_.str_;
 			large_.cap_ = str.large_.cap_;
+			SET_LARGE_SIZE(*this, SIZE(str));
+
+			str.large_.str_ = nullptr;
+			str.large_.cap_ = 0;
 		}
 		else
 		{
-			memcpy(small_.str_, str.small_.str_, len_ + 1);
+			memcpy(small_.str_, str.small_.str_, SIZE(str) + 1);
+			SET_SMALL_SIZE(*this, SIZE(str));
 		}
 
-		str.len_ = 0;
+		str.small_.str_[0] = '\0';
+		SET_SMALL_SIZE(str, 0);
 	}
 
 	string& string::operator=(char const* str)
@@ -617,7 +655,7 @@ namespace mc
 
 	void string::insert(uint32_t idx, uint32_t count, char c)
 	{
-		if (idx == len_)
+		if (idx == SIZE(*this))
 		{
 			append(count, c);
 		}
@@ -654,7 +692,7 @@ namespace mc
 					memset(large_.str_ + idx, c, count);
 				}
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else if (new_len >= small_size)
 			{
@@ -668,7 +706,7 @@ namespace mc
 				large_.str_ = new_str;
 				large_.cap_ = new_len;
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else
 			{
@@ -676,14 +714,14 @@ namespace mc
 				        SIZE(*this) - idx + 1);
 				memset(small_.str_ + idx, c, count);
 
-				len_ = new_len;
+				SET_SMALL_SIZE(*this, new_len);
 			}
 		}
 	}
 
 	void string::insert(uint32_t idx, char const* str, uint32_t count)
 	{
-		if (idx == len_)
+		if (idx == SIZE(*this))
 		{
 			append(str, count);
 		}
@@ -723,7 +761,7 @@ namespace mc
 					memcpy(large_.str_ + idx, str, count);
 				}
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else if (new_len >= small_size)
 			{
@@ -737,7 +775,7 @@ namespace mc
 				large_.str_ = new_str;
 				large_.cap_ = new_len;
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else
 			{
@@ -745,14 +783,14 @@ namespace mc
 				        SIZE(*this) - idx + 1);
 				memcpy(small_.str_ + idx, str, count);
 
-				len_ = new_len;
+				SET_SMALL_SIZE(*this, new_len);
 			}
 		}
 	}
 
 	void string::insert(uint32_t idx, string const& str, uint32_t pos, uint32_t count)
 	{
-		if (idx == len_)
+		if (idx == SIZE(*this))
 		{
 			append(str, pos, count);
 		}
@@ -792,7 +830,7 @@ namespace mc
 					memcpy(large_.str_ + idx, DATA(str) + pos, count);
 				}
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else if (new_len >= small_size)
 			{
@@ -806,7 +844,7 @@ namespace mc
 				large_.str_ = new_str;
 				large_.cap_ = new_len;
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else
 			{
@@ -814,7 +852,7 @@ namespace mc
 				        SIZE(*this) - idx + 1);
 				memcpy(small_.str_ + idx, DATA(str) + pos, count);
 
-				len_ = new_len;
+				SET_SMALL_SIZE(*this, new_len);
 			}
 		}
 	}
@@ -822,7 +860,7 @@ namespace mc
 	void string::insert(uint32_t idx, string_view const& str, uint32_t pos,
 	                    uint32_t count)
 	{
-		if (idx == len_)
+		if (idx == SIZE(*this))
 		{
 			append(str, pos, count);
 		}
@@ -862,7 +900,7 @@ namespace mc
 					memcpy(large_.str_ + idx, str.data() + pos, count);
 				}
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else if (new_len >= small_size)
 			{
@@ -876,7 +914,7 @@ namespace mc
 				large_.str_ = new_str;
 				large_.cap_ = new_len;
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else
 			{
@@ -884,14 +922,14 @@ namespace mc
 				        SIZE(*this) - idx + 1);
 				memcpy(small_.str_ + idx, str.data() + pos, count);
 
-				len_ = new_len;
+				SET_SMALL_SIZE(*this, new_len);
 			}
 		}
 	}
 
 	void string::insert(uint32_t idx, std::initializer_list<char> ilist)
 	{
-		if (idx == len_)
+		if (idx == SIZE(*this))
 		{
 			append(ilist);
 		}
@@ -928,7 +966,7 @@ namespace mc
 					memcpy(large_.str_ + idx, ilist.begin(), count);
 				}
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else if (new_len >= small_size)
 			{
@@ -942,7 +980,7 @@ namespace mc
 				large_.str_ = new_str;
 				large_.cap_ = new_len;
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else
 			{
@@ -950,7 +988,7 @@ namespace mc
 				        SIZE(*this) - idx + 1);
 				memcpy(small_.str_ + idx, ilist.begin(), count);
 
-				len_ = new_len;
+				SET_SMALL_SIZE(*this, new_len);
 			}
 		}
 	}
@@ -986,7 +1024,7 @@ namespace mc
 				large_.str_[new_len] = '\0';
 			}
 
-			len_ = new_len | is_large_flag;
+			SET_LARGE_SIZE(*this, new_len);
 		}
 		else if (new_len >= small_size)
 		{
@@ -999,14 +1037,14 @@ namespace mc
 			large_.str_ = new_str;
 			large_.cap_ = new_len;
 
-			len_ = new_len | is_large_flag;
+			SET_LARGE_SIZE(*this, new_len);
 		}
 		else
 		{
 			memset(small_.str_ + SIZE(*this), c, count);
 			small_.str_[new_len] = '\0';
 
-			len_ = new_len;
+			SET_SMALL_SIZE(*this, new_len);
 		}
 	}
 
@@ -1044,7 +1082,7 @@ namespace mc
 				large_.str_[new_len] = '\0';
 			}
 
-			len_ = new_len | is_large_flag;
+			SET_LARGE_SIZE(*this, new_len);
 		}
 		else if (new_len >= small_size)
 		{
@@ -1057,14 +1095,14 @@ namespace mc
 			large_.str_ = new_str;
 			large_.cap_ = new_len;
 
-			len_ = new_len | is_large_flag;
+			SET_LARGE_SIZE(*this, new_len);
 		}
 		else
 		{
 			memcpy(small_.str_ + SIZE(*this), str, count);
 			small_.str_[new_len] = '\0';
 
-			len_ = new_len;
+			SET_SMALL_SIZE(*this, new_len);
 		}
 	}
 
@@ -1102,7 +1140,7 @@ namespace mc
 				large_.str_[new_len] = '\0';
 			}
 
-			len_ = new_len | is_large_flag;
+			SET_LARGE_SIZE(*this, new_len);
 		}
 		else if (new_len >= small_size)
 		{
@@ -1115,14 +1153,14 @@ namespace mc
 			large_.str_ = new_str;
 			large_.cap_ = new_len;
 
-			len_ = new_len | is_large_flag;
+			SET_LARGE_SIZE(*this, new_len);
 		}
 		else
 		{
 			memcpy(small_.str_ + SIZE(*this), DATA(str) + pos, count);
 			small_.str_[new_len] = '\0';
 
-			len_ = new_len;
+			SET_SMALL_SIZE(*this, new_len);
 		}
 	}
 
@@ -1160,7 +1198,7 @@ namespace mc
 				large_.str_[new_len] = '\0';
 			}
 
-			len_ = new_len | is_large_flag;
+			SET_LARGE_SIZE(*this, new_len);
 		}
 		else if (new_len >= small_size)
 		{
@@ -1173,14 +1211,14 @@ namespace mc
 			large_.str_ = new_str;
 			large_.cap_ = new_len;
 
-			len_ = new_len | is_large_flag;
+			SET_LARGE_SIZE(*this, new_len);
 		}
 		else
 		{
 			memcpy(small_.str_ + SIZE(*this), str.data() + pos, count);
 			small_.str_[new_len] = '\0';
 
-			len_ = new_len;
+			SET_SMALL_SIZE(*this, new_len);
 		}
 	}
 
@@ -1215,7 +1253,7 @@ namespace mc
 				large_.str_[new_len] = '\0';
 			}
 
-			len_ = new_len | is_large_flag;
+			SET_LARGE_SIZE(*this, new_len);
 		}
 		else if (new_len >= small_size)
 		{
@@ -1228,15 +1266,63 @@ namespace mc
 			large_.str_ = new_str;
 			large_.cap_ = new_len;
 
-			len_ = new_len | is_large_flag;
+			SET_LARGE_SIZE(*this, new_len);
 		}
 		else
 		{
 			memcpy(small_.str_ + SIZE(*this), ilist.begin(), count);
 			small_.str_[new_len] = '\0';
 
-			len_ = new_len;
+			SET_SMALL_SIZE(*this, new_len);
+		}
+	}
+
+	char* string::append_uninitialized(uint32_t count)
+	{
+		count &= ~is_large_flag;
+
+		uint32_t len = SIZE(*this);
+		uint32_t new_len = len + count;
+		if (IS_LARGE(*this))
+		{
+			if (new_len > large_.cap_)
+			{
+				uint32_t new_cap = large_.cap_;
+				while (new_cap < new_len)
+					new_cap *= 2;
+
+				char* new_str =
+					reinterpret_cast<char*>(alloc(new_cap + 1, alignof(char)));
+
+				memcpy(new_str, large_.str_, len);
+				free(large_.str_, large_.cap_ + 1, alignof(char));
+
+				large_.str_ = new_str;
+				large_.cap_ = new_cap;
+			}
+
+			large_.str_[new_len] = '\0';
+			SET_LARGE_SIZE(*this, new_len);
+		}
+		else if (new_len >= small_size)
+		{
+			char* new_str = reinterpret_cast<char*>(alloc(new_len + 1, alignof(char)));
+
+			memcpy(new_str, small_.str_, len);
+			new_str[new_len] = '\0';
+
+			large_.str_ = new_str;
+			large_.cap_ = new_len;
+
+			SET_LARGE_SIZE(*this, new_len);
+		}
+		else
+		{
+			small_.str_[new_len] = '\0';
+			SET_SMALL_SIZE(*this, new_len);
 		}
+
+		return DATA(*this) + len;
 	}
 
 	string& string::operator+=(char const* str)
@@ -1303,7 +1389,7 @@ namespace mc
 					memset(large_.str_ + idx, c, count2);
 				}
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else if (new_len >= small_size)
 			{
@@ -1318,7 +1404,7 @@ namespace mc
 				large_.str_ = new_str;
 				large_.cap_ = new_len;
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else
 			{
@@ -1326,14 +1412,14 @@ namespace mc
 				        SIZE(*this) - idx - count + 1);
 				memset(small_.str_ + idx, c, count2);
 
-				len_ = new_len;
+				SET_SMALL_SIZE(*this, new_len);
 			}
 		}
 	}
 
 	void string::replace(uint32_t idx, uint32_t count, char const* str, uint32_t count2)
 	{
-		if (idx == len_)
+		if (idx == SIZE(*this))
 		{
 			append(str, count2);
 		}
@@ -1374,7 +1460,7 @@ namespace mc
 					memcpy(large_.str_ + idx, str, count2);
 				}
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else if (new_len >= small_size)
 			{
@@ -1389,7 +1475,7 @@ namespace mc
 				large_.str_ = new_str;
 				large_.cap_ = new_len;
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else
 			{
@@ -1397,7 +1483,7 @@ namespace mc
 				        SIZE(*this) - idx - count + 1);
 				memcpy(small_.str_ + idx, str, count2);
 
-				len_ = new_len;
+				SET_SMALL_SIZE(*this, new_len);
 			}
 		}
 	}
@@ -1405,7 +1491,7 @@ namespace mc
 	void string::replace(uint32_t idx, uint32_t count, string const& str, uint32_t pos,
 	                     uint32_t count2)
 	{
-		if (idx == len_)
+		if (idx == SIZE(*this))
 		{
 			append(str, pos, count2);
 		}
@@ -1446,7 +1532,7 @@ namespace mc
 					memcpy(large_.str_ + idx, DATA(str) + pos, count2);
 				}
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else if (new_len >= small_size)
 			{
@@ -1461,7 +1547,7 @@ namespace mc
 				large_.str_ = new_str;
 				large_.cap_ = new_len;
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else
 			{
@@ -1469,7 +1555,7 @@ namespace mc
 				        SIZE(*this) - idx - count + 1);
 				memcpy(small_.str_ + idx, DATA(str) + pos, count2);
 
-				len_ = new_len;
+				SET_SMALL_SIZE(*this, new_len);
 			}
 		}
 	}
@@ -1477,7 +1563,7 @@ namespace mc
 	void string::replace(uint32_t idx, uint32_t count, string_view const& str,
 	                     uint32_t pos, uint32_t count2)
 	{
-		if (idx == len_)
+		if (idx == SIZE(*this))
 		{
 			append(str, pos, count2);
 		}
@@ -1518,7 +1604,7 @@ namespace mc
 					memcpy(large_.str_ + idx, str.data() + pos, count2);
 				}
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else if (new_len >= small_size)
 			{
@@ -1533,7 +1619,7 @@ namespace mc
 				large_.str_ = new_str;
 				large_.cap_ = new_len;
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else
 			{
@@ -1541,14 +1627,14 @@ namespace mc
 				        SIZE(*this) - idx - count + 1);
 				memcpy(small_.str_ + idx, str.data() + pos, count2);
 
-				len_ = new_len;
+				SET_SMALL_SIZE(*this, new_len);
 			}
 		}
 	}
 
 	void string::replace(uint32_t idx, uint32_t count, std::initializer_list<char> ilist)
 	{
-		if (idx == len_)
+		if (idx == SIZE(*this))
 		{
 			append(ilist);
 		}
@@ -1586,7 +1672,7 @@ namespace mc
 					memcpy(large_.str_ + idx, ilist.begin(), count2);
 				}
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else if (new_len >= small_size)
 			{
@@ -1601,7 +1687,7 @@ namespace mc
 				large_.str_ = new_str;
 				large_.cap_ = new_len;
 
-				len_ = new_len | is_large_flag;
+				SET_LARGE_SIZE(*this, new_len);
 			}
 			else
 			{
@@ -1609,7 +1695,7 @@ namespace mc
 				        SIZE(*this) - idx - count + 1);
 				memcpy(small_.str_ + idx, ilist.begin(), count2);
 
-				len_ = new_len;
+				SET_SMALL_SIZE(*this, new_len);
 			}
 		}
 	}
@@ -1619,7 +1705,7 @@ namespace mc
 		memmove(DATA(*this) + idx, DATA(*this) + idx + count,
 		        SIZE(*this) - idx - count + 1);
 
-		len_ = SIZE(*this) - count | (len_ & is_large_flag);
+		SET_SIZE(*this, SIZE(*this) - count);
 	}
 
 	void string::push_back(char c)
@@ -1651,7 +1737,7 @@ namespace mc
 				large_.str_[new_len] = '\0';
 			}
 
-			len_ = new_len | is_large_flag;
+			SET_LARGE_SIZE(*this, new_len);
 		}
 		else if (new_len >= small_size)
 		{
@@ -1664,21 +1750,21 @@ namespace mc
 			large_.str_ = new_str;
 			large_.cap_ = new_len;
 
-			len_ = new_len | is_large_flag;
+			SET_LARGE_SIZE(*this, new_len);
 		}
 		else
 		{
 			small_.str_[SIZE(*this)] = c;
 			small_.str_[new_len] = '\0';
 
-			len_ = new_len;
+			SET_SMALL_SIZE(*this, new_len);
 		}
 	}
 
 	void string::pop_back()
 	{
 		DATA(*this)[SIZE(*this) - 1] = '\0';
-		len_ = SIZE(*this) - 1 | (len_ & is_large_flag);
+		SET_SIZE(*this, SIZE(*this) - 1);
 	}
 
 	string string::substr(uint32_t pos, uint32_t size) const&
@@ -1693,360 +1779,201 @@ namespace mc
 
 	int32_t string::compare(string const& str) const
 	{
-		uint32_t len = SIZE(*this) < SIZE(str) ? SIZE(*this) : SIZE(str);
-		int32_t  res = strncmp(DATA(*this), DATA(str), len);
-
-		if (res == 0)
-		{
-			if (SIZE(*this) < SIZE(str))
-				return -1;
-			else if (SIZE(*this) > SIZE(str))
-				return 1;
-		}
-
-		return res;
+		return compare(string_view(str));
 	}
 
 	int32_t string::compare(string_view str) const
 	{
-		uint32_t len = SIZE(*this) < str.size() ? SIZE(*this) : str.size();
-		int32_t  res = strncmp(DATA(*this), str.data(), len);
-
-		if (res == 0)
-		{
-			if (SIZE(*this) < str.size())
-				return -1;
-			else if (SIZE(*this) > str.size())
-				return 1;
-		}
-
-		return res;
+		return __internal::compare_strings(DATA(*this), SIZE(*this), str.data(),
+		                                   str.size());
 	}
 
 	int32_t string::compare(char const* str) const
 	{
-		uint32_t str_len = static_cast<uint32_t>(strlen(str));
-		uint32_t len = SIZE(*this) < str_len ? SIZE(*this) : str_len;
-		int32_t  res = strncmp(DATA(*this), str, len);
-
-		if (res == 0)
-		{
-			if (SIZE(*this) < str_len)
-				return -1;
-			else if (SIZE(*this) > str_len)
-				return 1;
-		}
-
-		return res;
+		return compare(string_view(str));
 	}
 
 	bool string::starts_with(string const& str) const
 	{
-		return strncmp(DATA(*this), DATA(str), SIZE(str)) == 0;
+		return starts_with(string_view(str));
 	}
 
 	bool string::starts_with(string_view str) const
 	{
-		return strncmp(DATA(*this), str.data(), str.size()) == 0;
+		if (str.size() > SIZE(*this))
+			return false;
+		return __internal::equal_bytes(DATA(*this), str.data(), str.size());
 	}
 
 	bool string::starts_with(char const* str) const
 	{
-		return strncmp(DATA(*this), str, strlen(str)) == 0;
+		return starts_with(string_view(str));
 	}
 
 	bool string::starts_with(char c) const
 	{
-		return DATA(*this)[0] == c;
+		return SIZE(*this) != 0 && DATA(*this)[0] == c;
 	}
 
 	bool string::ends_with(string const& str) const
 	{
-		return strncmp(DATA(*this) + SIZE(*this) - SIZE(str), DATA(str), SIZE(str)) == 0;
+		return ends_with(string_view(str));
 	}
 
 	bool string::ends_with(string_view str) const
 	{
-		return strncmp(DATA(*this) + SIZE(*this) - str.size(), str.data(), str.size()) ==
-		       0;
+		if (str.size() > SIZE(*this))
+			return false;
+
+		char const* suffix = DATA(*this) + SIZE(*this) - str.size();
+		return __internal::equal_bytes(suffix, str.data(), str.size());
 	}
 
 	bool string::ends_with(char const* str) const
 	{
-		uint32_t len = strlen(str);
-		return strncmp(DATA(*this) + SIZE(*this) - len, str, len) == 0;
+		return ends_with(string_view(str));
 	}
 
 	bool string::ends_with(char c) const
 	{
-		return DATA(*this)[SIZE(*this) - 1] == c;
+		return SIZE(*this) != 0 && DATA(*this)[SIZE(*this) - 1] == c;
 	}
 
 	bool string::contains(string const& str) const
 	{
-		if (SIZE(str) > SIZE(*this) || SIZE(str) == 0)
-			return false;
-
-		for (uint32_t i {0}, j {0}; i < len_; ++i)
-		{
-			if (len_ - i < SIZE(str) - j)
-				return false;
-
-			if (DATA(*this)[i] == DATA(str)[j])
-			{
-				++j;
-				if (j == SIZE(str))
-					return true;
-			}
-			else
-				j = 0;
-		}
-		return false;
+		return find(str) != UINT32_MAX;
 	}
 
 	bool string::contains(string_view str) const
 	{
-		if (str.size() > SIZE(*this) || str.size() == 0)
-			return false;
-
-		for (uint32_t i {0}, j {0}; i < SIZE(*this); ++i)
-		{
-			if (SIZE(*this) - i < str.size() - j)
-				return false;
-
-			if (DATA(*this)[i] == str.data()[j])
-			{
-				++j;
-				if (j == str.size())
-					return true;
-			}
-			else
-				j = 0;
-		}
-		return false;
+		return find(str) != UINT32_MAX;
 	}
 
 	bool string::contains(char const* str) const
 	{
-		uint32_t len = strlen(str);
-		if (len > SIZE(*this) || len == 0)
-			return false;
-
-		for (uint32_t i {0}, j {0}; i < SIZE(*this); ++i)
-		{
-			if (SIZE(*this) - i < len - j)
-				return false;
-
-			if (DATA(*this)[i] == str[j])
-			{
-				++j;
-				if (j == len)
-					return true;
-			}
-			else
-				j = 0;
-		}
-		return false;
+		return find(str) != UINT32_MAX;
 	}
 
 	bool string::contains(char c) const
 	{
-		for (uint32_t i {0}; i < SIZE(*this); ++i)
-			if (DATA(*this)[i] == c)
-				return true;
-		return false;
+		return find(c) != UINT32_MAX;
 	}
 
 	uint32_t string::find(string const& str, uint32_t pos) const
 	{
-		if (SIZE(str) > SIZE(*this) - pos || SIZE(str) == 0)
-			return UINT32_MAX;
-
-		uint32_t match = 0;
-		for (uint32_t i {pos}, j {0}; i < SIZE(*this); ++i)
-		{
-			if (SIZE(*this) - i < SIZE(str) - j)
-				return UINT32_MAX;
-
-			if (DATA(*this)[i] == DATA(str)[j])
-			{
-				if (j == 0)
-					match = i;
-				++j;
-				if (j == SIZE(str))
-					return match;
-			}
-			else
-				j = 0;
-		}
-		return UINT32_MAX;
+		return find(string_view(str), pos);
 	}
 
 	uint32_t string::find(string_view str, uint32_t pos) const
 	{
-		if (str.size() > SIZE(*this) - pos || str.size() == 0)
+		if (str.size() == 0 || pos >= SIZE(*this))
 			return UINT32_MAX;
 
-		uint32_t match = 0;
-		for (uint32_t i {pos}, j {0}; i < SIZE(*this); ++i)
-		{
-			if (SIZE(*this) - i < str.size() - j)
-				return UINT32_MAX;
-
-			if (DATA(*this)[i] == str.data()[j])
-			{
-				if (j == 0)
-					match = i;
-				++j;
-				if (j == str.size())
-					return match;
-			}
-			else
-				j = 0;
-		}
-		return UINT32_MAX;
+		uint32_t res = __internal::find_substr(DATA(*this) + pos, SIZE(*this) - pos,
+		                                       str.data(), str.size());
+		return res == UINT32_MAX ? UINT32_MAX : pos + res;
 	}
 
 	uint32_t string::find(char const* str, uint32_t pos) const
 	{
-		uint32_t len = strlen(str);
-		if (len > SIZE(*this) - pos || len == 0)
-			return UINT32_MAX;
-
-		uint32_t match = 0;
-		for (uint32_t i {pos}, j {0}; i < SIZE(*this); ++i)
-		{
-			if (SIZE(*this) - i < len - j)
-				return UINT32_MAX;
-
-			if (DATA(*this)[i] == str[j])
-			{
-				if (j == 0)
-					match = i;
-				++j;
-				if (j == len)
-					return match;
-			}
-			else
-				j = 0;
-		}
-		return UINT32_MAX;
+		return find(string_view(str), pos);
 	}
 
 	uint32_t string::find(char c, uint32_t pos) const
 	{
-		for (uint32_t i {pos}; i < SIZE(*this); ++i)
-			if (DATA(*this)[i] == c)
-				return i;
-		return UINT32_MAX;
+		if (pos >= SIZE(*this))
+			return UINT32_MAX;
+
+		uint32_t res = __internal::find_char(DATA(*this) + pos, SIZE(*this) - pos, c);
+		return res == UINT32_MAX ? UINT32_MAX : pos + res;
 	}
 
 	uint32_t string::rfind(string const& str, uint32_t pos) const
 	{
-		if (pos == UINT32_MAX)
-			pos = SIZE(*this) - 1;
+		return rfind(string_view(str), pos);
+	}
 
-		if (SIZE(str) > pos || SIZE(str) == 0)
+	uint32_t string::rfind(string_view str, uint32_t pos) const
+	{
+		if (str.size() == 0 || SIZE(*this) == 0)
 			return UINT32_MAX;
+		if (pos >= SIZE(*this))
+			pos = SIZE(*this) - 1;
 
-		for (uint32_t i {pos + 1}, j {SIZE(str)}; i > 0; --i)
-		{
-			if (i < j)
-				return UINT32_MAX;
+		// The match ends at pos at most.
+		return __internal::rfind_substr(DATA(*this), pos + 1, str.data(), str.size());
+	}
 
-			if (DATA(*this)[i - 1] == DATA(str)[j - 1])
-			{
-				--j;
-				if (j == 0)
-					return i - 1;
-			}
-			else
-				j = SIZE(str);
-		}
-		return UINT32_MAX;
+	uint32_t string::rfind(char const* str, uint32_t pos) const
+	{
+		return rfind(string_view(str), pos);
 	}
 
-	uint32_t string::rfind(string_view str, uint32_t pos) const
+	uint32_t string::rfind(char c, uint32_t pos) const
 	{
-		if (pos == UINT32_MAX)
+		if (SIZE(*this) == 0)
+			return UINT32_MAX;
+		if (pos >= SIZE(*this))
 			pos = SIZE(*this) - 1;
 
-		if (str.size() > pos || str.size() == 0)
-			return UINT32_MAX;
+		return __internal::rfind_char(DATA(*this), pos + 1, c);
+	}
 
-		for (uint32_t i {pos + 1}, j {str.size()}; i > 0; --i)
-		{
-			if (i < j)
-				return UINT32_MAX;
+	uint32_t string::find_first_of(string_view chars, uint32_t pos) const
+	{
+		return char_set(chars).find(*this, pos);
+	}
 
-			if (DATA(*this)[i - 1] == str.data()[j - 1])
-			{
-				--j;
-				if (j == 0)
-					return i - 1;
-			}
-			else
-				j = str.size();
-		}
-		return UINT32_MAX;
+	uint32_t string::find_first_of(char_set const& set, uint32_t pos) const
+	{
+		return set.find(*this, pos);
 	}
 
-	uint32_t string::rfind(char const* str, uint32_t pos) const
+	uint32_t string::find_first_not_of(string_view chars, uint32_t pos) const
 	{
-		uint32_t len = strlen(str);
-		if (pos == UINT32_MAX)
-			pos = SIZE(*this) - 1;
+		return char_set(chars).find_not(*this, pos);
+	}
 
-		if (len > pos || len == 0)
-			return UINT32_MAX;
+	uint32_t string::find_first_not_of(char_set const& set, uint32_t pos) const
+	{
+		return set.find_not(*this, pos);
+	}
 
-		for (uint32_t i {pos + 1}, j {len}; i > 0; --i)
-		{
-			if (i < j)
-				return UINT32_MAX;
+	uint32_t string::find_last_of(string_view chars, uint32_t pos) const
+	{
+		return char_set(chars).rfind(*this, pos);
+	}
 
-			if (DATA(*this)[i - 1] == str[j - 1])
-			{
-				--j;
-				if (j == 0)
-					return i - 1;
-			}
-			else
-				j = len;
-		}
-		return UINT32_MAX;
+	uint32_t string::find_last_of(char_set const& set, uint32_t pos) const
+	{
+		return set.rfind(*this, pos);
 	}
 
-	uint32_t string::rfind(char c, uint32_t pos) const
+	uint32_t string::find_last_not_of(string_view chars, uint32_t pos) const
 	{
-		if (pos == UINT32_MAX)
-			pos = SIZE(*this) - 1;
+		return char_set(chars).rfind_not(*this, pos);
+	}
 
-		for (uint32_t i {pos + 1}; i > 0; --i)
-			if (DATA(*this)[i - 1] == c)
-				return i - 1;
-		return UINT32_MAX;
+	uint32_t string::find_last_not_of(char_set const& set, uint32_t pos) const
+	{
+		return set.rfind_not(*this, pos);
 	}
 
 	bool string::operator==(string const& str) const
 	{
-		if (SIZE(*this) != SIZE(str))
-			return false;
-		return strncmp(DATA(*this), DATA(str), SIZE(*this)) == 0;
+		return *this == string_view(str);
 	}
 
 	bool string::operator==(string_view str) const
 	{
 		if (SIZE(*this) != str.size())
 			return false;
-		return strncmp(DATA(*this), str.data(), SIZE(*this)) == 0;
+		return __internal::equal_bytes(DATA(*this), str.data(), str.size());
 	}
 
 	bool string::operator==(char const* str) const
 	{
-		if (SIZE(*this) != strlen(str))
-			return false;
-		return strncmp(DATA(*this), str, SIZE(*this)) == 0;
+		return *this == string_view(str);
 	}
 
 	std::strong_ordering string::operator<=>(string const& str) const
@@ -2087,4 +2014,42 @@ namespace mc
 		else
 			return std::strong_ordering::equivalent;
 	}
+
+	string __internal::concat_views(string_view const* parts, uint32_t count,
+	                                string* head)
+	{
+		uint32_t size {0};
+		for (uint32_t i {0}; i < count; ++i)
+			size += parts[i].size();
+
+		// The head holds parts[0], so the other parts are appended after it. They may
+		// view the head itself, which isn't reallocated.
+		if (head != nullptr && size <= head->capacity())
+		{
+			char* str = head->append_uninitialized(size - parts[0].size());
+			for (uint32_t i {1}; i < count; ++i)
+			{
+				if (parts[i].empty())
+					continue;
+
+				memcpy(str, parts[i].data(), parts[i].size());
+				str += parts[i].size();
+			}
+
+			return static_cast<string&&>(*head);
+		}
+
+		string res;
+		char*  str = res.append_uninitialized(size);
+		for (uint32_t i {0}; i < count; ++i)
+		{
+			if (parts[i].empty())
+				continue;
+
+			memcpy(str, parts[i].data(), parts[i].size());
+			str += parts[i].size();
+		}
+
+		return res;
+	}
 } // namespace mc
@@ -5,6 +5,7 @@
 #include "config.hh"
 
 #include "compare.hh"
+#include "concepts.hh"
 #include "initializer_list.hh"
 #include "string_view.hh"
 
@@ -43,6 +44,11 @@ namespace mc
 		void fit();
 
 		void resize(uint32_t size, char c = '\0');
+		// Resizes the string to count characters without initializing the new ones, then
+		// calls op(data(), count). op writes the characters and returns the final size,
+		// which must not exceed count.
+		template <typename Op>
+		void resize_and_overwrite(uint32_t count, Op op);
 
 		void assign(uint32_t count, char c);
 		// TODO assign first last
@@ -74,6 +80,9 @@ namespace mc
 		void append(string_view const& str, uint32_t pos = 0,
 		            uint32_t count = UINT32_MAX);
 		void append(std::initializer_list<char> ilist);
+		// Grows the string by count characters left uninitialized, growing the storage at
+		// most once. Returns a pointer to the first of them, for the caller to write.
+		char* append_uninitialized(uint32_t count);
 
 		string& operator+=(char const* str);
 		string& operator+=(string_view str);
@@ -127,6 +136,15 @@ namespace mc
 		uint32_t rfind(char const* str, uint32_t pos = UINT32_MAX) const;
 		uint32_t rfind(char c, uint32_t pos = UINT32_MAX) const;
 
+		uint32_t find_first_of(string_view chars, uint32_t pos = 0) const;
+		uint32_t find_first_of(char_set const& set, uint32_t pos = 0) const;
+		uint32_t find_first_not_of(string_view chars, uint32_t pos = 0) const;
+		uint32_t find_first_not_of(char_set const& set, uint32_t pos = 0) const;
+		uint32_t find_last_of(string_view chars, uint32_t pos = UINT32_MAX) const;
+		uint32_t find_last_of(char_set const& set, uint32_t pos = UINT32_MAX) const;
+		uint32_t find_last_not_of(string_view chars, uint32_t pos = UINT32_MAX) const;
+		uint32_t find_last_not_of(char_set const& set, uint32_t pos = UINT32_MAX) const;
+
 		bool operator==(string const& str) const;
 		bool operator==(string_view str) const;
 		bool operator==(char const* str) const;
@@ -144,7 +162,15 @@ namespace mc
 		char const& back() const&& = delete;
 
 	private:
+#ifdef STRING_COMPACT
+		// The small buffer spans the whole string, its last byte holding the number of
+		// unused characters. It is thus 0 for a full small string, acting as the null
+		// terminator. Large strings set large_tag in this byte instead.
+		static constexpr uint32_t small_size = STRING_SMALL_SIZE + 8;
+		static constexpr uint8_t  large_tag = 0x80;
+#else
 		static constexpr uint32_t small_size = STRING_SMALL_SIZE;
+#endif
 		static constexpr uint32_t is_large_flag = 0x8000'0000;
 
 		union
@@ -152,6 +178,9 @@ namespace mc
 			struct
 			{
 				char*    str_ {nullptr};
+#ifdef STRING_COMPACT
+				uint32_t len_ {0};
+#endif
 				uint32_t cap_ {0};
 			} large_;
 
@@ -162,8 +191,172 @@ namespace mc
 			} small_;
 		};
 
+#ifndef STRING_COMPACT
 		uint32_t len_ {0};
+#endif
 	};
 
 	static_assert(STRING_SMALL_SIZE >= 16 && STRING_SMALL_SIZE % 8 == 0);
+#ifdef STRING_COMPACT
+	static_assert(STRING_SMALL_SIZE <= 120, "small size must fit below the large tag");
+#endif
+
+	namespace __internal
+	{
+		// Types accepted as pieces by concat and operator+.
+		template <typename T>
+		concept string_piece = same_as<T, string> || same_as<T, string_view> ||
+		                       convertible_to<T const&, char const*>;
+
+		// Pending concatenation built by operator+, allocated once when converted to a
+		// string. It refers to its pieces, so it must be converted within the expression
+		// that created it.
+		template <uint32_t N>
+		struct string_concat
+		{
+			string_view parts[N];
+			// Rvalue string viewed by parts[0], whose buffer is reused when it can hold
+			// the whole result.
+			string* head {nullptr};
+
+			operator string() const;
+		};
+
+		string_view piece_view(string const& str);
+		string_view piece_view(string_view str);
+		string_view piece_view(char const* str);
+
+		string concat_views(string_view const* parts, uint32_t count,
+		                    string* head = nullptr);
+
+		// Declared here to be found by argument-dependent lookup.
+		template <uint32_t N, string_piece R>
+		string_concat<N + 1> operator+(string_concat<N> const& lhs, R const& rhs);
+		template <string_piece L, uint32_t N>
+		string_concat<N + 1> operator+(L const& lhs, string_concat<N> const& rhs);
+		template <uint32_t N, uint32_t M>
+		string_concat<N + M> operator+(string_concat<N> const& lhs,
+		                               string_concat<M> const& rhs);
+		template <uint32_t N>
+		string_concat<N + 1> operator+(string&& lhs, string_concat<N> const& rhs);
+	}
+
+	// Concatenates the pieces into a string allocated once.
+	template <__internal::string_piece... Parts>
+		requires(sizeof...(Parts) > 0)
+	string concat(Parts const&... parts);
+
+	template <__internal::string_piece L, __internal::string_piece R>
+	__internal::string_concat<2> operator+(L const& lhs, R const& rhs);
+	// Appends to the buffer of lhs when converted, if it is large enough.
+	template <__internal::string_piece R>
+	__internal::string_concat<2> operator+(string&& lhs, R const& rhs);
+}
+
+namespace mc
+{
+	template <typename Op>
+	void string::resize_and_overwrite(uint32_t count, Op op)
+	{
+		if (count > size())
+			append_uninitialized(count - size());
+		else
+			resize(count);
+
+		resize(op(data(), count));
+	}
+
+	template <uint32_t N>
+	__internal::string_concat<N>::operator string() const
+	{
+		return concat_views(parts, N, head);
+	}
+
+	inline string_view __internal::piece_view(string const& str)
+	{
+		return {str.data(), str.size()};
+	}
+
+	inline string_view __internal::piece_view(string_view str)
+	{
+		return str;
+	}
+
+	inline string_view __internal::piece_view(char const* str)
+	{
+		return str;
+	}
+
+	template <__internal::string_piece... Parts>
+		requires(sizeof...(Parts) > 0)
+	string concat(Parts const&... parts)
+	{
+		string_view views[] {__internal::piece_view(parts)...};
+		return __internal::concat_views(views, sizeof...(Parts));
+	}
+
+	template <__internal::string_piece L, __internal::string_piece R>
+	__internal::string_concat<2> operator+(L const& lhs, R const& rhs)
+	{
+		return {__internal::piece_view(lhs), __internal::piece_view(rhs)};
+	}
+
+	template <uint32_t N, __internal::string_piece R>
+	__internal::string_concat<N + 1> __internal::operator+(string_concat<N> const& lhs,
+	                                                       R const& rhs)
+	{
+		string_concat<N + 1> res;
+		for (uint32_t i {0}; i < N; ++i)
+			res.parts[i] = lhs.parts[i];
+		res.parts[N] = piece_view(rhs);
+		res.head = lhs.head;
+
+		return res;
+	}
+
+	template <__internal::string_piece L, uint32_t N>
+	__internal::string_concat<N + 1> __internal::operator+(L const& lhs,
+	                                                       string_concat<N> const& rhs)
+	{
+		// The buffer of rhs.head can't be reused, its content isn't first anymore.
+		string_concat<N + 1> res;
+		res.parts[0] = piece_view(lhs);
+		for (uint32_t i {0}; i < N; ++i)
+			res.parts[i + 1] = rhs.parts[i];
+
+		return res;
+	}
+
+	template <uint32_t N, uint32_t M>
+	__internal::string_concat<N + M> __internal::operator+(string_concat<N> const& lhs,
+	                                                       string_concat<M> const& rhs)
+	{
+		string_concat<N + M> res;
+		for (uint32_t i {0}; i < N; ++i)
+			res.parts[i] = lhs.parts[i];
+		for (uint32_t i {0}; i < M; ++i)
+			res.parts[N + i] = rhs.parts[i];
+		res.head = lhs.head;
+
+		return res;
+	}
+
+	template <uint32_t N>
+	__internal::string_concat<N + 1> __internal::operator+(string&& lhs,
+	                                                       string_concat<N> const& rhs)
+	{
+		string_concat<N + 1> res;
+		res.parts[0] = piece_view(lhs);
+		for (uint32_t i {0}; i < N; ++i)
+			res.parts[i + 1] = rhs.parts[i];
+		res.head = &lhs;
+
+		return res;
+	}
+
+	template <__internal::string_piece R>
+	__internal::string_concat<2> operator+(string&& lhs, R const& rhs)
+	{
+		return {{__internal::piece_view(lhs), __internal::piece_view(rhs)}, &lhs};
+	}
 }
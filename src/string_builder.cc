@@ -0,0 +1,161 @@
+#include "string_builder.hh"
+
+#include "alloc.hh"
+#include "utility.hh"
+
+#include <string.h>
+
+namespace mc
+{
+	string_builder::string_builder(string_builder&& other)
+	: chunks_ {move(other.chunks_)}
+	, size_ {other.size_}
+	{
+		other.size_ = 0;
+	}
+
+	string_builder::~string_builder()
+	{
+		clear();
+	}
+
+	string_builder& string_builder::operator=(string_builder&& other)
+	{
+		if (this != &other)
+		{
+			clear();
+
+			chunks_ = move(other.chunks_);
+			size_ = other.size_;
+			other.size_ = 0;
+		}
+
+		return *this;
+	}
+
+	bool string_builder::empty() const
+	{
+		return size_ == 0;
+	}
+
+	uint32_t string_builder::size() const
+	{
+		return size_;
+	}
+
+	void string_builder::append(string_view str)
+	{
+		uint32_t size = str.size();
+		char const* data = str.data();
+
+		// Fills the current chunk before opening a new one, so that only the last
+		// chunk may be partially used.
+		if (!chunks_.empty())
+		{
+			__internal::builder_chunk& chunk = chunks_.back();
+
+			uint32_t len = chunk.cap - chunk.size;
+			if (len > size)
+				len = size;
+
+			if (len != 0)
+			{
+				memcpy(chunk.str + chunk.size, data, len);
+				chunk.size += len;
+				size_ += len;
+				data += len;
+				size -= len;
+			}
+		}
+
+		if (size != 0)
+			memcpy(append_uninitialized(size), data, size);
+	}
+
+	void string_builder::append(uint32_t count, char c)
+	{
+		if (count != 0)
+			memset(append_uninitialized(count), c, count);
+	}
+
+	void string_builder::push_back(char c)
+	{
+		*append_uninitialized(1) = c;
+	}
+
+	char* string_builder::append_uninitialized(uint32_t count)
+	{
+		char* str = reserve(count);
+
+		chunks_.back().size += count;
+		size_ += count;
+
+		return str;
+	}
+
+	string_builder& string_builder::operator+=(string_view str)
+	{
+		append(str);
+		return *this;
+	}
+
+	void string_builder::clear()
+	{
+		for (uint32_t i {0}; i < chunks_.size(); ++i)
+			free(chunks_[i].str, chunks_[i].cap, alignof(char));
+
+		chunks_.clear();
+		size_ = 0;
+	}
+
+	string string_builder::to_string() const
+	{
+		string res;
+		char*  str = res.append_uninitialized(size_);
+
+		for (uint32_t i {0}; i < chunks_.size(); ++i)
+		{
+			if (chunks_[i].size == 0)
+				continue;
+
+			memcpy(str, chunks_[i].str, chunks_[i].size);
+			str += chunks_[i].size;
+		}
+
+		return res;
+	}
+
+	vector<string_view> string_builder::chunks() const
+	{
+		vector<string_view> res;
+		res.reserve(chunks_.size());
+
+		for (uint32_t i {0}; i < chunks_.size(); ++i)
+			if (chunks_[i].size != 0)
+				res.emplace_back(chunks_[i].str, chunks_[i].size);
+
+		return res;
+	}
+
+	char* string_builder::reserve(uint32_t count)
+	{
+		if (!chunks_.empty())
+		{
+			__internal::builder_chunk& chunk = chunks_.back();
+			if (chunk.cap - chunk.size >= count)
+				return chunk.str + chunk.size;
+		}
+
+		uint32_t cap = chunks_.empty() ? min_chunk_size : chunks_.back().cap * 2;
+		if (cap > max_chunk_size)
+			cap = max_chunk_size;
+		if (cap < count)
+			cap = count;
+
+		__internal::builder_chunk& chunk = chunks_.emplace_back();
+		chunk.str = reinterpret_cast<char*>(alloc(cap, alignof(char)));
+		chunk.cap = cap;
+
+		return chunk.str;
+	}
+}
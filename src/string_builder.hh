@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "string.hh"
+#include "string_view.hh"
+#include "vector.hh"
+
+namespace mc
+{
+	namespace __internal
+	{
+		struct builder_chunk
+		{
+			char*    str {nullptr};
+			uint32_t size {0};
+			uint32_t cap {0};
+		};
+	}
+
+	/// @brief Builds a string out of appended pieces, without copying on growth.
+	/// @details Pieces are written in chunks allocated with alloc(). Each chunk is twice
+	/// as large as the previous one, up to max_chunk_size, and full chunks are never
+	/// moved. The result is either copied once into a string by to_string(), or read in
+	/// place through chunks(), e.g. for gather writes.
+	class string_builder
+	{
+	public:
+		string_builder() = default;
+		string_builder(string_builder const&) = delete;
+		// Takes the chunks of other, which is left empty.
+		string_builder(string_builder&& other);
+		~string_builder();
+
+		string_builder& operator=(string_builder const&) = delete;
+		string_builder& operator=(string_builder&& other);
+
+		bool     empty() const;
+		uint32_t size() const;
+
+		void append(string_view str);
+		void append(uint32_t count, char c);
+		void push_back(char c);
+		// Returns count contiguous characters left uninitialized, for the caller to
+		// write. The rest of the current chunk is skipped if it is too small.
+		char* append_uninitialized(uint32_t count);
+
+		string_builder& operator+=(string_view str);
+
+		// Frees the chunks.
+		void clear();
+
+		// Copies the chunks into a string allocated once.
+		string to_string() const;
+		// Views of the non-empty chunks, in order. They are valid until the next call
+		// to clear() or the destruction of the builder.
+		vector<string_view> chunks() const;
+
+	private:
+		static constexpr uint32_t min_chunk_size = 256;
+		static constexpr uint32_t max_chunk_size = 1 << 20;
+
+		// Returns the free space of the last chunk, a new one being allocated if it has
+		// less than count characters left.
+		char* reserve(uint32_t count);
+
+		vector<__internal::builder_chunk> chunks_;
+		uint32_t                          size_ {0};
+	};
+}
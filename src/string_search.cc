@@ -0,0 +1,488 @@
+#include "string_search.hh"
+
+#include "bit.hh"
+#include "cpu.hh"
+#include "simd.hh"
+
+namespace mc
+{
+	namespace __internal
+	{
+		namespace
+		{
+			using byte_simd = native_simd<uint8_t>;
+
+			// Needles up to this size use the SIMD filter, longer ones Horspool.
+			constexpr uint32_t long_needle = 32;
+
+			uint8_t const* bytes(char const* str)
+			{
+				return reinterpret_cast<uint8_t const*>(str);
+			}
+
+			// Bytes of text and logs, from the most frequent. Unlisted bytes (control,
+			// non-ASCII) are the rarest.
+			constexpr char frequent_bytes[] =
+				" etaoinsrhldcu\nmfpgwy.b,v-k\"/:=0123456789_ETAOINSRHLDCUMFPGWYBVK"
+				"xjqzXJQZ\t;()'<>[]{}!?*&#%+|@$^~`\\\r";
+
+			// Ranks of the bytes, lower being rarer.
+			void byte_ranks(uint8_t* ranks)
+			{
+				for (uint32_t i {0}; i < 256; ++i)
+					ranks[i] = 0;
+
+				uint32_t count = sizeof(frequent_bytes) - 1;
+				for (uint32_t i {0}; i < count; ++i)
+					ranks[static_cast<uint8_t>(frequent_bytes[i])] = 255 - i;
+			}
+
+			// Modes of the char_set kernels.
+			constexpr uint32_t scan_not = 1;
+			constexpr uint32_t scan_reverse = 2;
+
+			using scan_func = uint32_t(uint8_t const* str, uint32_t size,
+			                           uint64_t const* bits, uint8_t const* low,
+			                           uint32_t mode);
+
+			uint32_t scan_generic(uint8_t const* str, uint32_t size, uint64_t const* bits,
+			                      [[maybe_unused]] uint8_t const* low, uint32_t mode)
+			{
+				bool negate = mode & scan_not;
+				auto matches = [&](uint8_t byte) {
+					return (((bits[byte / 64] >> (byte % 64)) & 1) != 0) != negate;
+				};
+
+				if (mode & scan_reverse)
+				{
+					for (uint32_t i {size}; i > 0; --i)
+					{
+						if (matches(str[i - 1]))
+							return i - 1;
+					}
+				}
+				else
+				{
+					for (uint32_t i {0}; i < size; ++i)
+					{
+						if (matches(str[i]))
+							return i;
+					}
+				}
+
+				return UINT32_MAX;
+			}
+
+#if defined(__x86_64__) || defined(__i386__)
+			using byte16 = simd<uint8_t, 16>;
+
+			__attribute__((target("ssse3"))) byte16
+			shuffle_bytes(byte16 table, byte16 idx)
+			{
+				using bytes = char __attribute__((vector_size(16)));
+				return byte16::vector_type(
+					__builtin_ia32_pshufb128(bytes(table.native()), bytes(idx.native())));
+			}
+
+			// Bit i set if byte i of block is in the set.
+			__attribute__((target("ssse3"))) uint32_t
+			match_ssse3(uint8_t const* block, byte16 ascii, byte16 high, byte16 bits)
+			{
+				byte16 bytes = byte16::load(block);
+				byte16 low = bytes & byte16(0x0f);
+
+				// Shuffles return 0 for indices with bit 7 set, so each low nibble table
+				// only answers for its half of the bytes.
+				byte16 in_ascii = shuffle_bytes(ascii, low | (bytes & byte16(0x80)));
+				byte16 in_high = shuffle_bytes(high, low | (~bytes & byte16(0x80)));
+				byte16 bit = shuffle_bytes(bits, bytes >> 4);
+
+				return (((in_ascii | in_high) & bit) != byte16(0)).bitmask();
+			}
+
+			__attribute__((target("ssse3"))) uint32_t
+			scan_ssse3(uint8_t const* str, uint32_t size, uint64_t const* bits,
+			           uint8_t const* low, uint32_t mode)
+			{
+				// Bit of each high nibble, modulo 8.
+				uint8_t const high_bits[16] {1, 2, 4, 8, 16, 32, 64, 128,
+				                             1, 2, 4, 8, 16, 32, 64, 128};
+
+				byte16   ascii = byte16::load(low);
+				byte16   high = byte16::load(low + 16);
+				byte16   bit = byte16::load(high_bits);
+				uint32_t flip = mode & scan_not ? 0xffff : 0;
+
+				if (mode & scan_reverse)
+				{
+					uint32_t end {size};
+					for (; end >= 16; end -= 16)
+					{
+						uint32_t first = end - 16;
+						uint32_t mask = match_ssse3(str + first, ascii, high, bit) ^ flip;
+						if (mask)
+							return first + bit_width(mask) - 1;
+					}
+
+					return scan_generic(str, end, bits, low, mode);
+				}
+
+				uint32_t i {0};
+				for (; i + 16 <= size; i += 16)
+				{
+					uint32_t mask = match_ssse3(str + i, ascii, high, bit) ^ flip;
+					if (mask)
+						return i + countr_zero(mask);
+				}
+
+				uint32_t res = scan_generic(str + i, size - i, bits, low, mode);
+				return res == UINT32_MAX ? UINT32_MAX : i + res;
+			}
+#endif
+
+			dispatched<scan_func> scan_set {[]() -> scan_func* {
+#if defined(__x86_64__) || defined(__i386__)
+				if (cpu_supports(cpu_feature::ssse3))
+					return &scan_ssse3;
+#endif
+				return &scan_generic;
+			}};
+
+			// Candidates are the positions where the bytes at offsets first and second
+			// match the needle, found for a whole register of positions by two loads and
+			// comparisons. The needle is then compared at each candidate.
+			uint32_t find_simd(uint8_t const* str, uint32_t size, uint8_t const* needle,
+			                   uint32_t needle_size, uint32_t first, uint32_t second)
+			{
+				byte_simd first_byte(needle[first]);
+				byte_simd second_byte(needle[second]);
+
+				// Candidates are the positions before end.
+				uint32_t end = size - needle_size + 1;
+
+				uint32_t i {0};
+				for (; i + byte_simd::lanes <= end; i += byte_simd::lanes)
+				{
+					auto mask = ((byte_simd::load(str + i + first) == first_byte) &
+					             (byte_simd::load(str + i + second) == second_byte))
+					                .bitmask();
+					for (; mask != 0; mask &= mask - 1)
+					{
+						uint32_t idx = i + countr_zero(mask);
+						if (__builtin_memcmp(str + idx, needle, needle_size) == 0)
+							return idx;
+					}
+				}
+
+				for (; i < end; ++i)
+				{
+					if (str[i + first] == needle[first] &&
+					    __builtin_memcmp(str + i, needle, needle_size) == 0)
+						return i;
+				}
+
+				return UINT32_MAX;
+			}
+
+			uint32_t rfind_simd(uint8_t const* str, uint32_t size, uint8_t const* needle,
+			                    uint32_t needle_size)
+			{
+				byte_simd first(needle[0]);
+				byte_simd last(needle[needle_size - 1]);
+				uint32_t  middle = needle_size - 2;
+
+				// Candidates are the positions before end, a register at a time from the
+				// last one.
+				uint32_t end = size - needle_size + 1;
+				for (; end >= byte_simd::lanes; end -= byte_simd::lanes)
+				{
+					uint32_t i = end - byte_simd::lanes;
+					auto     mask = ((byte_simd::load(str + i) == first) &
+					                 (byte_simd::load(str + i + needle_size - 1) == last))
+					                    .bitmask();
+					while (mask != 0)
+					{
+						uint32_t bit = bit_width(mask) - 1;
+						if (__builtin_memcmp(str + i + bit + 1, needle + 1, middle) == 0)
+							return i + bit;
+						mask ^= decltype(mask)(1) << bit;
+					}
+				}
+
+				for (; end > 0; --end)
+				{
+					uint32_t i = end - 1;
+					if (str[i] == needle[0] &&
+					    __builtin_memcmp(str + i + 1, needle + 1, needle_size - 1) == 0)
+						return i;
+				}
+
+				return UINT32_MAX;
+			}
+
+			// Boyer-Moore-Horspool: on a mismatch, the window moves so its last byte
+			// aligns with the last previous occurrence of this byte in the needle.
+			void horspool_table(uint8_t const* needle, uint32_t needle_size,
+			                    uint32_t* skip)
+			{
+				for (uint32_t i {0}; i < 256; ++i)
+					skip[i] = needle_size;
+				for (uint32_t i {0}; i < needle_size - 1; ++i)
+					skip[needle[i]] = needle_size - 1 - i;
+			}
+
+			uint32_t find_horspool(uint8_t const* str, uint32_t size,
+			                       uint8_t const* needle, uint32_t needle_size,
+			                       uint32_t const* skip)
+			{
+				uint8_t last = needle[needle_size - 1];
+				for (uint32_t i {0}; i + needle_size <= size;)
+				{
+					uint8_t c = str[i + needle_size - 1];
+					if (c == last &&
+					    __builtin_memcmp(str + i, needle, needle_size - 1) == 0)
+						return i;
+					i += skip[c];
+				}
+
+				return UINT32_MAX;
+			}
+
+			// Horspool scanning backward: the window moves so its first byte aligns with
+			// the next occurrence of this byte in the needle.
+			uint32_t rfind_horspool(uint8_t const* str, uint32_t size,
+			                        uint8_t const* needle, uint32_t needle_size)
+			{
+				uint32_t skip[256];
+				for (uint32_t i {0}; i < 256; ++i)
+					skip[i] = needle_size;
+				for (uint32_t i {needle_size - 1}; i > 0; --i)
+					skip[needle[i]] = i;
+
+				uint8_t  first = needle[0];
+				uint32_t i = size - needle_size;
+				while (true)
+				{
+					uint8_t c = str[i];
+					if (c == first &&
+					    __builtin_memcmp(str + i + 1, needle + 1, needle_size - 1) == 0)
+						return i;
+					if (i < skip[c])
+						return UINT32_MAX;
+					i -= skip[c];
+				}
+			}
+		}
+
+		uint32_t find_char(char const* str, uint32_t size, char c)
+		{
+			byte_simd      needle(static_cast<uint8_t>(c));
+			uint8_t const* data = bytes(str);
+
+			uint32_t i {0};
+			for (; i + byte_simd::lanes <= size; i += byte_simd::lanes)
+			{
+				auto mask = (byte_simd::load(data + i) == needle).bitmask();
+				if (mask)
+					return i + countr_zero(mask);
+			}
+
+			if (i == size)
+				return UINT32_MAX;
+
+			// The tail is padded with a byte different from c.
+			uint8_t fill = static_cast<uint8_t>(c) + 1;
+			auto    mask = (byte_simd::load_partial(data + i, size - i, fill) == needle)
+			                .bitmask();
+			return mask ? i + countr_zero(mask) : UINT32_MAX;
+		}
+
+		uint32_t rfind_char(char const* str, uint32_t size, char c)
+		{
+			byte_simd      needle(static_cast<uint8_t>(c));
+			uint8_t const* data = bytes(str);
+
+			// Full registers from the end, the head being handled last.
+			uint32_t i {size};
+			for (; i >= byte_simd::lanes; i -= byte_simd::lanes)
+			{
+				uint32_t first = i - byte_simd::lanes;
+				auto     mask = (byte_simd::load(data + first) == needle).bitmask();
+				if (mask)
+					return first + bit_width(mask) - 1;
+			}
+
+			if (i == 0)
+				return UINT32_MAX;
+
+			uint8_t fill = static_cast<uint8_t>(c) + 1;
+			auto    mask = (byte_simd::load_partial(data, i, fill) == needle).bitmask();
+			return mask ? bit_width(mask) - 1 : UINT32_MAX;
+		}
+
+		uint32_t find_substr(char const* str, uint32_t size, char const* needle,
+		                     uint32_t needle_size)
+		{
+			if (needle_size > size)
+				return UINT32_MAX;
+			if (needle_size == 1)
+				return find_char(str, size, needle[0]);
+			if (needle_size <= long_needle)
+				return find_simd(bytes(str), size, bytes(needle), needle_size, 0,
+				                 needle_size - 1);
+
+			uint32_t skip[256];
+			horspool_table(bytes(needle), needle_size, skip);
+			return find_horspool(bytes(str), size, bytes(needle), needle_size, skip);
+		}
+
+		uint32_t rfind_substr(char const* str, uint32_t size, char const* needle,
+		                      uint32_t needle_size)
+		{
+			if (needle_size > size)
+				return UINT32_MAX;
+			if (needle_size == 1)
+				return rfind_char(str, size, needle[0]);
+			if (needle_size <= long_needle)
+				return rfind_simd(bytes(str), size, bytes(needle), needle_size);
+
+			return rfind_horspool(bytes(str), size, bytes(needle), needle_size);
+		}
+	}
+
+	string_searcher::string_searcher(string_view needle)
+	: needle_ {needle}
+	{
+		uint32_t size = needle.size();
+		if (size > __internal::long_needle)
+		{
+			__internal::horspool_table(__internal::bytes(needle.data()), size, skip_);
+			return;
+		}
+		if (size < 2)
+			return;
+
+		uint8_t ranks[256];
+		__internal::byte_ranks(ranks);
+
+		// Rarest byte, then rarest byte of another value if any, else another offset.
+		auto rank = [&](uint32_t idx) {
+			return ranks[static_cast<uint8_t>(needle[idx])];
+		};
+		for (uint32_t i {1}; i < size; ++i)
+		{
+			if (rank(i) < rank(rare_[0]))
+				rare_[0] = i;
+		}
+
+		rare_[1] = rare_[0] == 0 ? 1 : 0;
+		for (uint32_t i {0}; i < size; ++i)
+		{
+			if (i == rare_[0])
+				continue;
+
+			bool same = needle[i] == needle[rare_[0]];
+			bool best_same = needle[rare_[1]] == needle[rare_[0]];
+			if ((best_same && !same) || (same == best_same && rank(i) < rank(rare_[1])))
+				rare_[1] = i;
+		}
+	}
+
+	string_view string_searcher::needle() const
+	{
+		return needle_;
+	}
+
+	uint32_t string_searcher::find(string_view str, uint32_t idx) const
+	{
+		uint32_t size = needle_.size();
+		if (size == 0 || idx >= str.size() || size > str.size() - idx)
+			return UINT32_MAX;
+
+		uint8_t const* data = __internal::bytes(str.data() + idx);
+		uint8_t const* needle = __internal::bytes(needle_.data());
+
+		uint32_t res;
+		if (size == 1)
+			res = __internal::find_char(str.data() + idx, str.size() - idx, needle_[0]);
+		else if (size <= __internal::long_needle)
+			res = __internal::find_simd(data, str.size() - idx, needle, size, rare_[0],
+			                            rare_[1]);
+		else
+			res = __internal::find_horspool(data, str.size() - idx, needle, size, skip_);
+
+		return res == UINT32_MAX ? UINT32_MAX : idx + res;
+	}
+
+	vector<uint32_t> string_searcher::find_all(string_view str) const
+	{
+		vector<uint32_t> res;
+		for (uint32_t idx = find(str); idx != UINT32_MAX; idx = find(str, idx + 1))
+			res.emplace_back(idx);
+
+		return res;
+	}
+
+	char_set::char_set(string_view chars)
+	{
+		for (uint32_t i {0}; i < chars.size(); ++i)
+			add(chars[i]);
+	}
+
+	void char_set::add(char c)
+	{
+		uint8_t byte = static_cast<uint8_t>(c);
+		bits_[byte / 64] |= uint64_t(1) << (byte % 64);
+		low_[byte >> 7][byte & 15] |= 1 << ((byte >> 4) & 7);
+	}
+
+	bool char_set::contains(char c) const
+	{
+		uint8_t byte = static_cast<uint8_t>(c);
+		return (bits_[byte / 64] >> (byte % 64)) & 1;
+	}
+
+	uint32_t char_set::scan(string_view str, uint32_t first, uint32_t last,
+	                        uint32_t mode) const
+	{
+		uint8_t const* data = __internal::bytes(str.data() + first);
+		uint32_t res = __internal::scan_set(data, last - first, bits_, low_[0], mode);
+		return res == UINT32_MAX ? UINT32_MAX : first + res;
+	}
+
+	uint32_t char_set::find(string_view str, uint32_t idx) const
+	{
+		if (idx >= str.size())
+			return UINT32_MAX;
+
+		return scan(str, idx, str.size(), 0);
+	}
+
+	uint32_t char_set::find_not(string_view str, uint32_t idx) const
+	{
+		if (idx >= str.size())
+			return UINT32_MAX;
+
+		return scan(str, idx, str.size(), __internal::scan_not);
+	}
+
+	uint32_t char_set::rfind(string_view str, uint32_t idx) const
+	{
+		if (str.empty())
+			return UINT32_MAX;
+		if (idx >= str.size())
+			idx = str.size() - 1;
+
+		return scan(str, 0, idx + 1, __internal::scan_reverse);
+	}
+
+	uint32_t char_set::rfind_not(string_view str, uint32_t idx) const
+	{
+		if (str.empty())
+			return UINT32_MAX;
+		if (idx >= str.size())
+			idx = str.size() - 1;
+
+		return scan(str, 0, idx + 1, __internal::scan_not | __internal::scan_reverse);
+	}
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "bit.hh"
+#include "string.hh"
+#include "string_view.hh"
+#include "vector.hh"
+
+namespace mc
+{
+	/// @brief Substring search of a needle preprocessed once, to search it in many
+	/// strings.
+	/// @details The needle is copied. Needles up to 32 bytes filter candidates with SIMD
+	/// comparisons of their two rarest bytes, picked from a table of byte frequencies in
+	/// text and logs, so few candidates need a full comparison. Longer needles use a
+	/// precomputed Boyer-Moore-Horspool skip table.
+	class string_searcher
+	{
+	public:
+		string_searcher(string_view needle);
+
+		string_view needle() const;
+
+		// Index of the first occurrence of the needle in str at or after idx, or
+		// UINT32_MAX. An empty needle is never found, as in string_view::find().
+		uint32_t find(string_view str, uint32_t idx = 0) const;
+		// Indices of all the occurrences of the needle in str, overlapping ones included.
+		vector<uint32_t> find_all(string_view str) const;
+
+	private:
+		string needle_;
+		// Offsets in the needle of its two rarest bytes.
+		uint32_t rare_[2] {};
+		// Horspool shifts of long needles.
+		uint32_t skip_[256] {};
+	};
+
+	/// @brief Set of bytes, compiled for SIMD searches of any of its bytes in strings.
+	/// @details Membership is looked up from the two nibbles of each byte: a byte b is in
+	/// the set if bit (b >> 4) & 7 of low_[b >> 7][b & 15] is set. With SSSE3, the three
+	/// table lookups of 16 bytes are byte shuffles (pshufb), selected at runtime; other
+	/// targets use a 256 bits table.
+	class char_set
+	{
+	public:
+		char_set() = default;
+		char_set(string_view chars);
+
+		void add(char c);
+		bool contains(char c) const;
+
+		// Index of the first byte of str at or after idx in the set, or UINT32_MAX.
+		uint32_t find(string_view str, uint32_t idx = 0) const;
+		// Index of the first byte of str at or after idx not in the set, or UINT32_MAX.
+		uint32_t find_not(string_view str, uint32_t idx = 0) const;
+		// Index of the last byte of str at or before idx in the set, or UINT32_MAX.
+		uint32_t rfind(string_view str, uint32_t idx = UINT32_MAX) const;
+		// Index of the last byte of str at or before idx not in the set, or UINT32_MAX.
+		uint32_t rfind_not(string_view str, uint32_t idx = UINT32_MAX) const;
+
+	private:
+		// Kernel call over the bytes of str from first to last, excluded.
+		uint32_t scan(string_view str, uint32_t first, uint32_t last,
+		              uint32_t mode) const;
+
+		uint64_t bits_[4] {};
+		// Nibble tables of ASCII bytes, then of the others.
+		uint8_t low_[2][16] {};
+	};
+
+	namespace __internal
+	{
+		// Search kernels shared by string_view and string. They work on raw pointers and
+		// sizes, and return indices relative to str, UINT32_MAX meaning not found.
+
+		// Index of the first c in str, scanning a SIMD register at a time.
+		uint32_t find_char(char const* str, uint32_t size, char c);
+		// Index of the last c in str, scanning a SIMD register at a time.
+		uint32_t rfind_char(char const* str, uint32_t size, char c);
+
+		// Index of the first occurrence of needle in str. needle_size must not be 0.
+		// Needles up to 32 bytes filter candidates with SIMD comparisons of their first
+		// and last bytes, then compare the remaining bytes. Longer needles use
+		// Boyer-Moore-Horspool, whose shifts grow with the needle size.
+		uint32_t find_substr(char const* str, uint32_t size, char const* needle,
+		                     uint32_t needle_size);
+		// Index of the last occurrence of needle in str, same engines scanning backward.
+		uint32_t rfind_substr(char const* str, uint32_t size, char const* needle,
+		                      uint32_t needle_size);
+
+		// Comparisons of byte ranges, embedded NULs included. Ranges up to 16 bytes are
+		// compared as two possibly overlapping words, longer ones with memcmp. size may
+		// be 0 with null pointers.
+		bool    equal_bytes(char const* lhs, char const* rhs, uint32_t size);
+		int32_t compare_bytes(char const* lhs, char const* rhs, uint32_t size);
+		// Lexicographical comparison of two strings, -1, 0 or 1.
+		int32_t compare_strings(char const* lhs, uint32_t lhs_size, char const* rhs,
+		                        uint32_t rhs_size);
+	}
+}
+
+namespace mc
+{
+	namespace __internal
+	{
+		inline bool equal_bytes(char const* lhs, char const* rhs, uint32_t size)
+		{
+			if (size >= 8 && size <= 16)
+			{
+				uint64_t head =
+					load_unaligned<uint64_t>(lhs) ^ load_unaligned<uint64_t>(rhs);
+				uint64_t tail = load_unaligned<uint64_t>(lhs + size - 8) ^
+				                load_unaligned<uint64_t>(rhs + size - 8);
+				return (head | tail) == 0;
+			}
+			if (size >= 4 && size < 8)
+			{
+				uint32_t head =
+					load_unaligned<uint32_t>(lhs) ^ load_unaligned<uint32_t>(rhs);
+				uint32_t tail = load_unaligned<uint32_t>(lhs + size - 4) ^
+				                load_unaligned<uint32_t>(rhs + size - 4);
+				return (head | tail) == 0;
+			}
+			if (size < 4)
+			{
+				for (uint32_t i {0}; i < size; ++i)
+				{
+					if (lhs[i] != rhs[i])
+						return false;
+				}
+				return true;
+			}
+
+			return __builtin_memcmp(lhs, rhs, size) == 0;
+		}
+
+		inline int32_t compare_bytes(char const* lhs, char const* rhs, uint32_t size)
+		{
+			// Big endian words compare as their bytes in order.
+			if (size >= 8 && size <= 16)
+			{
+				uint64_t lhs_head = load_big_endian<uint64_t>(lhs);
+				uint64_t rhs_head = load_big_endian<uint64_t>(rhs);
+				if (lhs_head != rhs_head)
+					return lhs_head < rhs_head ? -1 : 1;
+
+				uint64_t lhs_tail = load_big_endian<uint64_t>(lhs + size - 8);
+				uint64_t rhs_tail = load_big_endian<uint64_t>(rhs + size - 8);
+				return lhs_tail == rhs_tail ? 0 : lhs_tail < rhs_tail ? -1 : 1;
+			}
+			if (size == 0)
+				return 0;
+
+			int32_t res = __builtin_memcmp(lhs, rhs, size);
+			return (res > 0) - (res < 0);
+		}
+
+		inline int32_t compare_strings(char const* lhs, uint32_t lhs_size,
+		                               char const* rhs, uint32_t rhs_size)
+		{
+			uint32_t size = lhs_size < rhs_size ? lhs_size : rhs_size;
+			int32_t  res = compare_bytes(lhs, rhs, size);
+			if (res != 0)
+				return res;
+
+			return (lhs_size > rhs_size) - (lhs_size < rhs_size);
+		}
+	}
+}
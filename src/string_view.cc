@@ -1,5 +1,7 @@
 #include "string_view.hh"
 
+#include "string_search.hh"
+
 #include <string.h>
 
 namespace mc
@@ -61,144 +63,126 @@ namespace mc
 
 	int32_t string_view::compare(string_view str) const
 	{
-		uint32_t len = len_ < str.len_ ? len_ : str.len_;
-		int32_t  res = strncmp(str_, str.str_, len);
-
-		if (res == 0)
-		{
-			if (len_ < str.len_)
-				return -1;
-			else if (len_ > str.len_)
-				return 1;
-		}
-
-		return res;
+		return __internal::compare_strings(str_, len_, str.str_, str.len_);
 	}
 
 	bool string_view::starts_with(string_view str) const
 	{
-		return strncmp(str_, str.str_, str.len_) == 0;
+		return str.len_ <= len_ && __internal::equal_bytes(str_, str.str_, str.len_);
 	}
 
 	bool string_view::starts_with(char c) const
 	{
-		return str_[0] == c;
+		return len_ != 0 && str_[0] == c;
 	}
 
 	bool string_view::ends_with(string_view str) const
 	{
-		return strncmp(str_ + len_ - str.len_, str.str_, str.len_) == 0;
+		if (str.len_ > len_)
+			return false;
+		return __internal::equal_bytes(str_ + len_ - str.len_, str.str_, str.len_);
 	}
 
 	bool string_view::ends_with(char c) const
 	{
-		return str_[len_ - 1] == c;
+		return len_ != 0 && str_[len_ - 1] == c;
 	}
 
 	bool string_view::contains(string_view str) const
 	{
-		if (str.len_ > len_ || str.len_ == 0)
-			return false;
-
-		for (uint32_t i {0}, j {0}; i < len_; ++i)
-		{
-			if (len_ - i < str.len_ - j)
-				return false;
-
-			if (str_[i] == str.str_[j])
-			{
-				++j;
-				if (j == str.len_)
-					return true;
-			}
-			else
-				j = 0;
-		}
-		return false;
+		return find(str) != UINT32_MAX;
 	}
 
 	bool string_view::contains(char c) const
 	{
-		for (uint32_t i {0}; i < len_; ++i)
-			if (str_[i] == c)
-				return true;
-		return false;
+		return find(c) != UINT32_MAX;
 	}
 
 	uint32_t string_view::find(string_view str, uint32_t idx) const
 	{
-		if (str.len_ > len_ - idx || str.len_ == 0)
+		if (str.len_ == 0 || idx >= len_)
 			return UINT32_MAX;
 
-		uint32_t match = 0;
-		for (uint32_t i {idx}, j {0}; i < len_; ++i)
-		{
-			if (len_ - i < str.len_ - j)
-				return UINT32_MAX;
-
-			if (str_[i] == str.str_[j])
-			{
-				if (j == 0)
-					match = i;
-				++j;
-				if (j == str.len_)
-					return match;
-			}
-			else
-				j = 0;
-		}
-		return UINT32_MAX;
+		uint32_t res =
+			__internal::find_substr(str_ + idx, len_ - idx, str.str_, str.len_);
+		return res == UINT32_MAX ? UINT32_MAX : idx + res;
 	}
 
 	uint32_t string_view::find(char c, uint32_t idx) const
 	{
-		for (uint32_t i {idx}; i < len_; ++i)
-			if (str_[i] == c)
-				return i;
-		return UINT32_MAX;
+		if (idx >= len_)
+			return UINT32_MAX;
+
+		uint32_t res = __internal::find_char(str_ + idx, len_ - idx, c);
+		return res == UINT32_MAX ? UINT32_MAX : idx + res;
 	}
 
 	uint32_t string_view::rfind(string_view str, uint32_t idx) const
 	{
-		if (idx == UINT32_MAX)
+		if (str.len_ == 0 || len_ == 0)
+			return UINT32_MAX;
+		if (idx >= len_)
 			idx = len_ - 1;
 
-		if (str.len_ > idx || str.len_ == 0)
+		// The match ends at idx at most.
+		return __internal::rfind_substr(str_, idx + 1, str.str_, str.len_);
+	}
+
+	uint32_t string_view::rfind(char c, uint32_t idx) const
+	{
+		if (len_ == 0)
 			return UINT32_MAX;
+		if (idx >= len_)
+			idx = len_ - 1;
 
-		for (uint32_t i {idx + 1}, j {str.len_}; i > 0; --i)
-		{
-			if (i < j)
-				return UINT32_MAX;
+		return __internal::rfind_char(str_, idx + 1, c);
+	}
 
-			if (str_[i - 1] == str.str_[j - 1])
-			{
-				--j;
-				if (j == 0)
-					return i - 1;
-			}
-			else
-				j = str.len_;
-		}
-		return UINT32_MAX;
+	uint32_t string_view::find_first_of(string_view chars, uint32_t idx) const
+	{
+		return char_set(chars).find(*this, idx);
 	}
 
-	uint32_t string_view::rfind(char c, uint32_t idx) const
+	uint32_t string_view::find_first_of(char_set const& set, uint32_t idx) const
 	{
-		if (idx == UINT32_MAX)
-			idx = len_ - 1;
+		return set.find(*this, idx);
+	}
+
+	uint32_t string_view::find_first_not_of(string_view chars, uint32_t idx) const
+	{
+		return char_set(chars).find_not(*this, idx);
+	}
+
+	uint32_t string_view::find_first_not_of(char_set const& set, uint32_t idx) const
+	{
+		return set.find_not(*this, idx);
+	}
+
+	uint32_t string_view::find_last_of(string_view chars, uint32_t idx) const
+	{
+		return char_set(chars).rfind(*this, idx);
+	}
+
+	uint32_t string_view::find_last_of(char_set const& set, uint32_t idx) const
+	{
+		return set.rfind(*this, idx);
+	}
 
-		for (uint32_t i {idx + 1}; i > 0; --i)
-			if (str_[i - 1] == c)
-				return i - 1;
-		return UINT32_MAX;
+	uint32_t string_view::find_last_not_of(string_view chars, uint32_t idx) const
+	{
+		return char_set(chars).rfind_not(*this, idx);
+	}
+
+	uint32_t string_view::find_last_not_of(char_set const& set, uint32_t idx) const
+	{
+		return set.rfind_not(*this, idx);
 	}
 
 	bool string_view::operator==(string_view str) const
 	{
 		if (len_ != str.len_)
 			return false;
-		return strncmp(str_, str.str_, len_) == 0;
+		return __internal::equal_bytes(str_, str.str_, len_);
 	}
 
 	std::strong_ordering string_view::operator<=>(string_view str) const
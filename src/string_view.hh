@@ -8,6 +8,8 @@ using nullptr_t = decltype(nullptr);
 
 namespace mc
 {
+	class char_set;
+
 	class string_view
 	{
 	public:
@@ -44,6 +46,17 @@ namespace mc
 		uint32_t rfind(string_view str, uint32_t idx = UINT32_MAX) const;
 		uint32_t rfind(char c, uint32_t idx = UINT32_MAX) const;
 
+		// Searches of any character of a set. Sets given as a string_view are compiled
+		// to a char_set on each call; reuse a char_set for repeated searches.
+		uint32_t find_first_of(string_view chars, uint32_t idx = 0) const;
+		uint32_t find_first_of(char_set const& set, uint32_t idx = 0) const;
+		uint32_t find_first_not_of(string_view chars, uint32_t idx = 0) const;
+		uint32_t find_first_not_of(char_set const& set, uint32_t idx = 0) const;
+		uint32_t find_last_of(string_view chars, uint32_t idx = UINT32_MAX) const;
+		uint32_t find_last_of(char_set const& set, uint32_t idx = UINT32_MAX) const;
+		uint32_t find_last_not_of(string_view chars, uint32_t idx = UINT32_MAX) const;
+		uint32_t find_last_not_of(char_set const& set, uint32_t idx = UINT32_MAX) const;
+
 		bool operator==(string_view str) const;
 
 		std::strong_ordering operator<=>(string_view str) const;
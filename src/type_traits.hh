@@ -17,6 +17,15 @@ namespace mc
 	template <bool Cond, typename True, typename False>
 	using conditional_t = conditional<Cond, True, False>::type;
 
+	template <typename T>
+	struct type_identity
+	{
+		using type = T;
+	};
+
+	template <typename T>
+	using type_identity_t = type_identity<T>::type;
+
 	template <typename T>
 	struct remove_pointer
 	{
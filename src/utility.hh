@@ -26,6 +26,24 @@ namespace mc
 	template <typename T>
 	using remove_reference_t = remove_reference<T>::type;
 
+	template <typename T>
+	struct remove_const
+	{
+		using type = T;
+	};
+
+	template <typename T>
+	struct remove_const<T const>
+	{
+		using type = T;
+	};
+
+	template <typename T>
+	using remove_const_t = remove_const<T>::type;
+
+	template <typename T>
+	using remove_cvref_t = remove_const_t<remove_reference_t<T>>;
+
 	template <typename T>
 	constexpr remove_reference_t<T>&& move(T&& t)
 	{
@@ -45,4 +63,11 @@ namespace mc
 		return static_cast<T&&>(t);
 	}
 
+	template <typename T>
+	constexpr void swap(T& lhs, T& rhs)
+	{
+		T tmp = move(lhs);
+		lhs = move(rhs);
+		rhs = move(tmp);
+	}
 }
\ No newline at end of file
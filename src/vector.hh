@@ -6,6 +6,7 @@
 #include "array_view.hh"
 #include "concepts.hh"
 #include "initializer_list.hh"
+#include "span.hh"
 
 namespace mc
 {
@@ -39,6 +40,7 @@ namespace mc
 		T const* data() const&;
 
 		operator array_view<T>() const&;
+		operator span<T>() &;
 
 		T&       operator[](uint32_t idx) &;
 		T const& operator[](uint32_t idx) const&;
@@ -201,6 +203,12 @@ namespace mc
 		return {arr_, size_};
 	}
 
+	template <vector_type T>
+	vector<T>::operator span<T>() &
+	{
+		return {arr_, size_};
+	}
+
 	template <vector_type T>
 	T& vector<T>::operator[](uint32_t idx) &
 	{
@@ -552,8 +560,12 @@ namespace mc
 				}
 			}
 
+			// After a reallocation, the gap was left unconstructed by the moves above.
 			for (uint32_t i {idx}; i < idx + count; ++i)
-				arr_[i] = val;
+				if (realloc)
+					new (arr_ + i) T(val);
+				else
+					arr_[i] = val;
 		}
 
 		size_ += count;
@@ -627,7 +639,10 @@ namespace mc
 					arr_[i] = static_cast<T&&>(arr_[i - 1]);
 			}
 
-			arr_[idx] = static_cast<T&&>(val);
+			if (realloc)
+				new (arr_ + idx) T(static_cast<T&&>(val));
+			else
+				arr_[idx] = static_cast<T&&>(val);
 		}
 
 		++size_;
@@ -725,7 +740,10 @@ namespace mc
 			T const* it = ilist.begin();
 			for (uint32_t i {idx}; i < idx + ilist.size(); ++i)
 			{
-				arr_[i] = *it;
+				if (realloc)
+					new (arr_ + i) T(*it);
+				else
+					arr_[i] = *it;
 				++it;
 			}
 		}
@@ -0,0 +1,487 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "array_view.hh"
+#include "concepts.hh"
+#include "pair.hh"
+#include "string_view.hh"
+#include "utility.hh"
+#include "vector.hh"
+
+namespace mc
+{
+	// Lazy views: adaptors which evaluate their elements one at a time, when they are
+	// consumed, without any intermediate storage. They are built from an array_view or
+	// a string_view with view(), then composed:
+	//
+	//   view<uint32_t>(arr).filter(is_odd).transform(square).take(10).for_each(print);
+	//
+	// Every view is a small value type following the same protocol: empty(), front()
+	// and pop_front(). Consuming a view works on a copy, so a view can be reused. Once
+	// inlined, a whole pipeline is a single loop over the source.
+
+	template <typename V>
+	concept lazy_view = requires(V v) {
+		{ v.empty() } -> convertible_to<bool>;
+		v.front();
+		v.pop_front();
+	};
+
+	template <typename Base, typename Pred>
+	class filter_view;
+	template <typename Base, typename F>
+	class transform_view;
+	template <typename Base>
+	class take_view;
+	template <typename Base>
+	class enumerate_view;
+	template <typename Base1, typename Base2>
+	class zip_view;
+	template <typename T, typename Slice>
+	class chunk_view;
+
+	/// @brief Adaptors and consumers shared by every view.
+	/// @tparam Derived view type, following the lazy_view protocol.
+	template <typename Derived>
+	class view_interface
+	{
+	public:
+		// Elements for which pred returns true.
+		template <typename Pred>
+		constexpr filter_view<Derived, Pred> filter(Pred pred) const;
+		// f applied to each element.
+		template <typename F>
+		constexpr transform_view<Derived, F> transform(F f) const;
+		// At most the count first elements.
+		constexpr take_view<Derived> take(uint32_t count) const;
+		// Pairs of an index (from 0) and an element.
+		constexpr enumerate_view<Derived> enumerate() const;
+		// Pairs of an element of this view and one of other, until one of them ends.
+		template <lazy_view Other>
+		constexpr zip_view<Derived, Other> zip(Other other) const;
+
+		template <typename F>
+		constexpr void     for_each(F f) const;
+		constexpr uint32_t count() const;
+		// Materializes the view. The only operation of this file which allocates.
+		auto to_vector() const;
+
+	private:
+		constexpr Derived const& derived() const;
+	};
+
+	/// @brief Elements of contiguous memory, the start of every pipeline.
+	/// @tparam T element type.
+	/// @tparam Slice view type of chunks, array_view<T> or string_view.
+	template <typename T, typename Slice = array_view<T>>
+	class source_view : public view_interface<source_view<T, Slice>>
+	{
+	public:
+		constexpr source_view(T const* data, uint32_t size);
+
+		constexpr bool     empty() const;
+		constexpr T const& front() const;
+		constexpr void     pop_front();
+
+		// Consecutive slices of size elements, the last one being possibly shorter. A
+		// size of 0 is taken as 1. Only available on sources, since slices of adapted
+		// views aren't contiguous.
+		constexpr chunk_view<T, Slice> chunk(uint32_t size) const;
+
+	private:
+		T const* begin_;
+		T const* end_;
+	};
+
+	template <typename T>
+	constexpr source_view<T> view(array_view<T> arr);
+	inline source_view<char, string_view> view(string_view str);
+
+	template <typename Base, typename Pred>
+	class filter_view : public view_interface<filter_view<Base, Pred>>
+	{
+	public:
+		constexpr filter_view(Base base, Pred pred);
+
+		constexpr bool           empty() const;
+		constexpr decltype(auto) front() const;
+		constexpr void           pop_front();
+
+	private:
+		// Moves the base view to the next element matching pred, unless already done.
+		// Called from the accessors, so that pred isn't run until the view is consumed.
+		constexpr void skip() const;
+
+		mutable Base base_;
+		mutable bool skipped_ {false};
+
+		[[no_unique_address]] Pred pred_;
+	};
+
+	template <typename Base, typename F>
+	class transform_view : public view_interface<transform_view<Base, F>>
+	{
+	public:
+		constexpr transform_view(Base base, F f);
+
+		constexpr bool           empty() const;
+		constexpr decltype(auto) front() const;
+		constexpr void           pop_front();
+
+	private:
+		Base base_;
+
+		[[no_unique_address]] F f_;
+	};
+
+	template <typename Base>
+	class take_view : public view_interface<take_view<Base>>
+	{
+	public:
+		constexpr take_view(Base base, uint32_t count);
+
+		constexpr bool           empty() const;
+		constexpr decltype(auto) front() const;
+		constexpr void           pop_front();
+
+	private:
+		Base     base_;
+		uint32_t count_;
+	};
+
+	template <typename Base>
+	class enumerate_view : public view_interface<enumerate_view<Base>>
+	{
+	public:
+		constexpr enumerate_view(Base base);
+
+		constexpr bool empty() const;
+		constexpr auto front() const;
+		constexpr void pop_front();
+
+	private:
+		Base     base_;
+		uint32_t idx_ {0};
+	};
+
+	template <typename Base1, typename Base2>
+	class zip_view : public view_interface<zip_view<Base1, Base2>>
+	{
+	public:
+		constexpr zip_view(Base1 base1, Base2 base2);
+
+		constexpr bool empty() const;
+		constexpr auto front() const;
+		constexpr void pop_front();
+
+	private:
+		Base1 base1_;
+		Base2 base2_;
+	};
+
+	template <typename T, typename Slice>
+	class chunk_view : public view_interface<chunk_view<T, Slice>>
+	{
+	public:
+		constexpr chunk_view(T const* begin, T const* end, uint32_t size);
+
+		constexpr bool  empty() const;
+		constexpr Slice front() const;
+		constexpr void  pop_front();
+
+	private:
+		constexpr uint32_t front_size() const;
+
+		T const* begin_;
+		T const* end_;
+		uint32_t size_;
+	};
+}
+
+namespace mc
+{
+	template <typename Derived>
+	template <typename Pred>
+	constexpr filter_view<Derived, Pred> view_interface<Derived>::filter(Pred pred) const
+	{
+		return {derived(), move(pred)};
+	}
+
+	template <typename Derived>
+	template <typename F>
+	constexpr transform_view<Derived, F> view_interface<Derived>::transform(F f) const
+	{
+		return {derived(), move(f)};
+	}
+
+	template <typename Derived>
+	constexpr take_view<Derived> view_interface<Derived>::take(uint32_t count) const
+	{
+		return {derived(), count};
+	}
+
+	template <typename Derived>
+	constexpr enumerate_view<Derived> view_interface<Derived>::enumerate() const
+	{
+		return {derived()};
+	}
+
+	template <typename Derived>
+	template <lazy_view Other>
+	constexpr zip_view<Derived, Other> view_interface<Derived>::zip(Other other) const
+	{
+		return {derived(), move(other)};
+	}
+
+	template <typename Derived>
+	template <typename F>
+	constexpr void view_interface<Derived>::for_each(F f) const
+	{
+		for (Derived v = derived(); !v.empty(); v.pop_front())
+			f(v.front());
+	}
+
+	template <typename Derived>
+	constexpr uint32_t view_interface<Derived>::count() const
+	{
+		uint32_t count {0};
+		for (Derived v = derived(); !v.empty(); v.pop_front())
+			++count;
+
+		return count;
+	}
+
+	template <typename Derived>
+	auto view_interface<Derived>::to_vector() const
+	{
+		vector<remove_cvref_t<decltype(derived().front())>> res;
+		for (Derived v = derived(); !v.empty(); v.pop_front())
+			res.emplace_back(v.front());
+
+		return res;
+	}
+
+	template <typename Derived>
+	constexpr Derived const& view_interface<Derived>::derived() const
+	{
+		return static_cast<Derived const&>(*this);
+	}
+
+	template <typename T, typename Slice>
+	constexpr source_view<T, Slice>::source_view(T const* data, uint32_t size)
+	: begin_ {data}
+	, end_ {data + size}
+	{}
+
+	template <typename T, typename Slice>
+	constexpr bool source_view<T, Slice>::empty() const
+	{
+		return begin_ == end_;
+	}
+
+	template <typename T, typename Slice>
+	constexpr T const& source_view<T, Slice>::front() const
+	{
+		return *begin_;
+	}
+
+	template <typename T, typename Slice>
+	constexpr void source_view<T, Slice>::pop_front()
+	{
+		++begin_;
+	}
+
+	template <typename T, typename Slice>
+	constexpr chunk_view<T, Slice> source_view<T, Slice>::chunk(uint32_t size) const
+	{
+		return {begin_, end_, size};
+	}
+
+	template <typename T>
+	constexpr source_view<T> view(array_view<T> arr)
+	{
+		return {arr.data(), arr.size()};
+	}
+
+	inline source_view<char, string_view> view(string_view str)
+	{
+		return {str.data(), str.size()};
+	}
+
+	template <typename Base, typename Pred>
+	constexpr filter_view<Base, Pred>::filter_view(Base base, Pred pred)
+	: base_ {move(base)}
+	, pred_ {move(pred)}
+	{}
+
+	template <typename Base, typename Pred>
+	constexpr bool filter_view<Base, Pred>::empty() const
+	{
+		skip();
+		return base_.empty();
+	}
+
+	template <typename Base, typename Pred>
+	constexpr decltype(auto) filter_view<Base, Pred>::front() const
+	{
+		skip();
+		return base_.front();
+	}
+
+	template <typename Base, typename Pred>
+	constexpr void filter_view<Base, Pred>::pop_front()
+	{
+		skip();
+		base_.pop_front();
+		skipped_ = false;
+	}
+
+	template <typename Base, typename Pred>
+	constexpr void filter_view<Base, Pred>::skip() const
+	{
+		if (skipped_)
+			return;
+
+		while (!base_.empty() && !pred_(base_.front()))
+			base_.pop_front();
+		skipped_ = true;
+	}
+
+	template <typename Base, typename F>
+	constexpr transform_view<Base, F>::transform_view(Base base, F f)
+	: base_ {move(base)}
+	, f_ {move(f)}
+	{}
+
+	template <typename Base, typename F>
+	constexpr bool transform_view<Base, F>::empty() const
+	{
+		return base_.empty();
+	}
+
+	template <typename Base, typename F>
+	constexpr decltype(auto) transform_view<Base, F>::front() const
+	{
+		return f_(base_.front());
+	}
+
+	template <typename Base, typename F>
+	constexpr void transform_view<Base, F>::pop_front()
+	{
+		base_.pop_front();
+	}
+
+	template <typename Base>
+	constexpr take_view<Base>::take_view(Base base, uint32_t count)
+	: base_ {move(base)}
+	, count_ {count}
+	{}
+
+	template <typename Base>
+	constexpr bool take_view<Base>::empty() const
+	{
+		return count_ == 0 || base_.empty();
+	}
+
+	template <typename Base>
+	constexpr decltype(auto) take_view<Base>::front() const
+	{
+		return base_.front();
+	}
+
+	template <typename Base>
+	constexpr void take_view<Base>::pop_front()
+	{
+		if (count_ == 0)
+			return;
+
+		// The base view isn't moved past the last taken element, which would make a
+		// filter scan the rest of its source for nothing.
+		if (--count_ != 0)
+			base_.pop_front();
+	}
+
+	template <typename Base>
+	constexpr enumerate_view<Base>::enumerate_view(Base base)
+	: base_ {move(base)}
+	{}
+
+	template <typename Base>
+	constexpr bool enumerate_view<Base>::empty() const
+	{
+		return base_.empty();
+	}
+
+	template <typename Base>
+	constexpr auto enumerate_view<Base>::front() const
+	{
+		return pair<uint32_t, decltype(base_.front())> {idx_, base_.front()};
+	}
+
+	template <typename Base>
+	constexpr void enumerate_view<Base>::pop_front()
+	{
+		base_.pop_front();
+		++idx_;
+	}
+
+	template <typename Base1, typename Base2>
+	constexpr zip_view<Base1, Base2>::zip_view(Base1 base1, Base2 base2)
+	: base1_ {move(base1)}
+	, base2_ {move(base2)}
+	{}
+
+	template <typename Base1, typename Base2>
+	constexpr bool zip_view<Base1, Base2>::empty() const
+	{
+		return base1_.empty() || base2_.empty();
+	}
+
+	template <typename Base1, typename Base2>
+	constexpr auto zip_view<Base1, Base2>::front() const
+	{
+		return pair<decltype(base1_.front()), decltype(base2_.front())> {base1_.front(),
+		                                                                  base2_.front()};
+	}
+
+	template <typename Base1, typename Base2>
+	constexpr void zip_view<Base1, Base2>::pop_front()
+	{
+		base1_.pop_front();
+		base2_.pop_front();
+	}
+
+	template <typename T, typename Slice>
+	constexpr chunk_view<T, Slice>::chunk_view(T const* begin, T const* end,
+	                                           uint32_t size)
+	: begin_ {begin}
+	, end_ {end}
+	, size_ {size == 0 ? 1 : size}
+	{}
+
+	template <typename T, typename Slice>
+	constexpr bool chunk_view<T, Slice>::empty() const
+	{
+		return begin_ == end_;
+	}
+
+	template <typename T, typename Slice>
+	constexpr Slice chunk_view<T, Slice>::front() const
+	{
+		return Slice(begin_, front_size());
+	}
+
+	template <typename T, typename Slice>
+	constexpr void chunk_view<T, Slice>::pop_front()
+	{
+		begin_ += front_size();
+	}
+
+	template <typename T, typename Slice>
+	constexpr uint32_t chunk_view<T, Slice>::front_size() const
+	{
+		uint32_t left = static_cast<uint32_t>(end_ - begin_);
+		return left < size_ ? left : size_;
+	}
+}
@@ -0,0 +1,58 @@
+#include "unit.hh"
+
+#include <aho_corasick.hh>
+#include <vector.hh>
+
+GROUP(aho_corasick)
+{
+	TEST(find_all)
+	{
+		mc::string_view    patterns[] {"he", "she", "his", "hers"};
+		mc::aho_corasick   matcher(patterns);
+		CHECK_EQ(matcher.pattern_count(), 4);
+		CHECK_EQ(matcher.state_count(), 10);
+
+		mc::vector<mc::aho_corasick::match> res = matcher.find_all("ushers");
+		CHECK_EQ(res.size(), 3);
+		CHECK_EQ(res[0].pattern, 1);
+		CHECK_EQ(res[0].idx, 1);
+		CHECK_EQ(res[1].pattern, 0);
+		CHECK_EQ(res[1].idx, 2);
+		CHECK_EQ(res[2].pattern, 3);
+		CHECK_EQ(res[2].idx, 2);
+
+		CHECK_EQ(matcher.find_all("").size(), 0);
+		CHECK_EQ(matcher.find_all("hi there").size(), 1);
+	}
+
+	TEST(overlaps)
+	{
+		// Nested, overlapping and duplicated patterns, and an empty one.
+		mc::string_view  patterns[] {"a", "aa", "", "aaa", "aa"};
+		mc::aho_corasick matcher(patterns);
+
+		uint32_t counts[5] {};
+		matcher.for_each_match("aaaa", [&](mc::aho_corasick::match m) {
+			++counts[m.pattern];
+			CHECK_EQ(m.idx < 4, true);
+		});
+		CHECK_EQ(counts[0], 4);
+		CHECK_EQ(counts[1], 3);
+		CHECK_EQ(counts[2], 0);
+		CHECK_EQ(counts[3], 2);
+		CHECK_EQ(counts[4], 3);
+	}
+
+	TEST(contains_any)
+	{
+		mc::string_view  patterns[] {"badword", "spam", mc::string_view("\xff\x00", 2)};
+		mc::aho_corasick matcher(patterns);
+
+		CHECK_EQ(matcher.contains_any("this is fine"), false);
+		CHECK_EQ(matcher.contains_any("buy spam now"), true);
+		CHECK_EQ(matcher.contains_any("bad word, badwor"), false);
+		CHECK_EQ(matcher.contains_any("xbadwordx"), true);
+		CHECK_EQ(matcher.contains_any("a\xff"), false);
+		CHECK_EQ(matcher.contains_any(mc::string_view("a\xff\x00", 3)), true);
+	}
+}
@@ -0,0 +1,123 @@
+#include "unit.hh"
+
+#include <algorithm.hh>
+#include <string.hh>
+#include <vector.hh>
+
+GROUP(algorithm)
+{
+	mc::vector<uint32_t> iota(uint32_t size)
+	{
+		mc::vector<uint32_t> vec;
+		for (uint32_t i {0}; i < size; ++i)
+			vec.emplace_back(i);
+
+		return vec;
+	}
+
+	TEST(find_count)
+	{
+		mc::vector<uint32_t> vec0 = iota(1000);
+		CHECK_EQ(mc::find<uint32_t>(vec0, 0), 0);
+		CHECK_EQ(mc::find<uint32_t>(vec0, 17), 17);
+		CHECK_EQ(mc::find<uint32_t>(vec0, 999), 999);
+		CHECK_EQ(mc::find<uint32_t>(vec0, 1000), UINT32_MAX);
+		CHECK_EQ(mc::find<uint32_t>({}, 0), UINT32_MAX);
+		auto above = [](uint32_t val) { return val > 500; };
+		CHECK_EQ(mc::find_if<uint32_t>(vec0, above), 501);
+
+		char str0[] = "find a char";
+		CHECK_EQ(mc::find<char>(str0, 'c'), 7);
+		CHECK_EQ(mc::find<char>(str0, 'z'), UINT32_MAX);
+
+		mc::string strs[3] {"a", "b", "a"};
+		CHECK_EQ(mc::find<mc::string>(strs, "b"), 1);
+		CHECK_EQ(mc::count<mc::string>(strs, "a"), 2);
+
+		mc::vector<uint32_t> vec1(100, 3);
+		vec1[40] = 4;
+		CHECK_EQ(mc::count<uint32_t>(vec1, 3), 99);
+		CHECK_EQ(mc::count_if<uint32_t>(vec1, [](uint32_t val) { return val == 4; }), 1);
+	}
+
+	TEST(fill_copy_equal)
+	{
+		mc::vector<uint32_t> vec0(100, 0);
+		mc::fill<uint32_t>(vec0, 7);
+		CHECK_EQ(mc::count<uint32_t>(vec0, 7), 100);
+
+		char str0[6] {};
+		mc::fill<char>(mc::span<char>(str0, 5), 'x');
+		CHECK_EQ(mc::string_view(str0) == "xxxxx", true);
+
+		mc::vector<uint32_t> vec1 = iota(100);
+		mc::vector<uint32_t> vec2(100, 0);
+		mc::copy<uint32_t>(vec1, vec2);
+		CHECK_EQ(mc::equal<uint32_t>(vec1, vec2), true);
+		vec2[99] = 0;
+		CHECK_EQ(mc::equal<uint32_t>(vec1, vec2), false);
+		CHECK_EQ(mc::equal<uint32_t>(vec1, mc::array_view<uint32_t>(vec1).subarr(0, 99)),
+		         false);
+
+		mc::string strs0[2] {"first", "a string too long for the small buffer"};
+		mc::string strs1[2];
+		mc::copy<mc::string>(strs0, strs1);
+		CHECK_EQ(mc::equal<mc::string>(strs0, strs1), true);
+
+		// NaN isn't equal to itself, even in the same array.
+		float arr0[2] {1.f, __builtin_nanf("")};
+		CHECK_EQ(mc::equal<float>(arr0, arr0), false);
+	}
+
+	TEST(min_max)
+	{
+		mc::vector<int32_t> vec0 {3, -2, 7, -2, 7, 0};
+		CHECK_EQ(mc::min_element<int32_t>(vec0), 1);
+		CHECK_EQ(mc::max_element<int32_t>(vec0), 2);
+
+		mc::pair<uint32_t, uint32_t> res0 = mc::minmax_element<int32_t>(vec0);
+		CHECK_EQ(res0.first, 1);
+		CHECK_EQ(res0.second, 2);
+
+		// Reversed order goes through the generic path.
+		CHECK_EQ(mc::min_element<int32_t>(vec0, mc::greater<int32_t>()), 2);
+		res0 = mc::minmax_element<int32_t>(vec0, mc::greater<int32_t>());
+		CHECK_EQ(res0.first, 2);
+		CHECK_EQ(res0.second, 1);
+
+		CHECK_EQ(mc::min_element<int32_t>({}), UINT32_MAX);
+
+		// A leading NaN compares false with everything, so it stays the result.
+		float arr0[2] {__builtin_nanf(""), 1.f};
+		CHECK_EQ(mc::min_element<float>(arr0), 0);
+		CHECK_EQ(mc::max_element<float>(arr0), 0);
+		CHECK_EQ(mc::minmax_element<float>(arr0).first, 0);
+
+		float arr1[3] {2.f, -1.f, 5.f};
+		CHECK_EQ(mc::min_element<float>(arr1), 1);
+		CHECK_EQ(mc::max_element<float>(arr1), 2);
+	}
+
+	TEST(accumulate)
+	{
+		mc::vector<uint32_t> vec0 = iota(1001);
+		CHECK_EQ(mc::accumulate<uint32_t>(vec0, 0), 500500);
+		CHECK_EQ(mc::accumulate<uint32_t>(vec0, 10), 500510);
+
+		mc::vector<float> vec1(37, 0.5f);
+		CHECK_EQ(mc::accumulate<float>(vec1, 1.f), 19.5f);
+
+		uint32_t arr0[4] {1, 2, 3, 4};
+		CHECK_EQ(mc::accumulate<uint32_t>(arr0, 1, [](uint32_t lhs, uint32_t rhs) {
+					 return lhs * rhs;
+				 }),
+		         24);
+
+		mc::string strs[3] {"a", "b", "c"};
+		auto       append = [](mc::string&& lhs, mc::string const& rhs) {
+			lhs += rhs;
+			return move(lhs);
+		};
+		CHECK_EQ(mc::accumulate<mc::string>(strs, "", append) == "abc", true);
+	}
+}
@@ -0,0 +1,78 @@
+#include "unit.hh"
+
+#include <stdint.h>
+
+#include <binary_search.hh>
+#include <vector.hh>
+
+GROUP(binary_search)
+{
+	TEST(lower_bound)
+	{
+		uint32_t arr[8] {1, 3, 3, 3, 5, 8, 13, 21};
+
+		CHECK_EQ(mc::lower_bound<uint32_t>(arr, 0), 0);
+		CHECK_EQ(mc::lower_bound<uint32_t>(arr, 1), 0);
+		CHECK_EQ(mc::lower_bound<uint32_t>(arr, 3), 1);
+		CHECK_EQ(mc::lower_bound<uint32_t>(arr, 4), 4);
+		CHECK_EQ(mc::lower_bound<uint32_t>(arr, 21), 7);
+		CHECK_EQ(mc::lower_bound<uint32_t>(arr, 22), 8);
+
+		mc::array_view<uint32_t> av0;
+		CHECK_EQ(mc::lower_bound(av0, 3), 0);
+
+		mc::vector<uint32_t> vec0;
+		for (uint32_t i {0}; i < 1000; ++i)
+			vec0.emplace_back(i * 2);
+
+		bool res {true};
+		for (uint32_t i {0}; i < 2001; ++i)
+			res &= mc::lower_bound<uint32_t>(vec0, i) == (i + 1) / 2;
+		CHECK_EQ(res, true);
+	}
+
+	TEST(upper_bound)
+	{
+		uint32_t arr[8] {1, 3, 3, 3, 5, 8, 13, 21};
+
+		CHECK_EQ(mc::upper_bound<uint32_t>(arr, 0), 0);
+		CHECK_EQ(mc::upper_bound<uint32_t>(arr, 1), 1);
+		CHECK_EQ(mc::upper_bound<uint32_t>(arr, 3), 4);
+		CHECK_EQ(mc::upper_bound<uint32_t>(arr, 4), 4);
+		CHECK_EQ(mc::upper_bound<uint32_t>(arr, 21), 8);
+
+		mc::array_view<uint32_t> av0;
+		CHECK_EQ(mc::upper_bound(av0, 3), 0);
+
+		uint32_t arr1[5] {21, 13, 8, 5, 3};
+		CHECK_EQ(mc::upper_bound(mc::array_view(arr1), 8u, mc::greater<uint32_t>()), 3);
+	}
+
+	TEST(equal_range)
+	{
+		uint32_t arr[8] {1, 3, 3, 3, 5, 8, 13, 21};
+
+		mc::pair<uint32_t, uint32_t> res0 = mc::equal_range<uint32_t>(arr, 3);
+		CHECK_EQ(res0.first, 1);
+		CHECK_EQ(res0.second, 4);
+
+		mc::pair<uint32_t, uint32_t> res1 = mc::equal_range<uint32_t>(arr, 4);
+		CHECK_EQ(res1.first, 4);
+		CHECK_EQ(res1.second, 4);
+
+		mc::pair<uint32_t, uint32_t> res2 = mc::equal_range<uint32_t>(arr, 30);
+		CHECK_EQ(res2.first, 8);
+		CHECK_EQ(res2.second, 8);
+	}
+
+	TEST(binary_search)
+	{
+		uint32_t arr[8] {1, 3, 3, 3, 5, 8, 13, 21};
+
+		CHECK_EQ(mc::binary_search<uint32_t>(arr, 3), true);
+		CHECK_EQ(mc::binary_search<uint32_t>(arr, 21), true);
+		CHECK_EQ(mc::binary_search<uint32_t>(arr, 0), false);
+		CHECK_EQ(mc::binary_search<uint32_t>(arr, 4), false);
+		CHECK_EQ(mc::binary_search<uint32_t>(arr, 22), false);
+	}
+}
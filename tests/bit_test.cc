@@ -0,0 +1,83 @@
+#include "unit.hh"
+
+#include <bit.hh>
+
+GROUP(bit)
+{
+	TEST(count)
+	{
+		static_assert(mc::popcount(0xf0f0u) == 8);
+		CHECK_EQ(mc::popcount(uint8_t(0xff)), 8);
+		CHECK_EQ(mc::popcount(UINT64_MAX), 64);
+
+		CHECK_EQ(mc::countl_zero(uint8_t(1)), 7);
+		CHECK_EQ(mc::countl_zero(uint16_t(0)), 16);
+		CHECK_EQ(mc::countl_zero(uint32_t(1) << 20), 11);
+		CHECK_EQ(mc::countl_zero(uint64_t(1)), 63);
+
+		CHECK_EQ(mc::countr_zero(uint8_t(0)), 8);
+		CHECK_EQ(mc::countr_zero(uint32_t(8)), 3);
+		CHECK_EQ(mc::countr_zero(uint64_t(1) << 40), 40);
+
+		CHECK_EQ(mc::countl_one(uint8_t(0xf0)), 4);
+		CHECK_EQ(mc::countr_one(uint32_t(0b0111)), 3);
+		CHECK_EQ(mc::countr_one(UINT32_MAX), 32);
+	}
+
+	TEST(pow2)
+	{
+		static_assert(mc::bit_ceil(5u) == 8);
+		CHECK_EQ(mc::has_single_bit(64u), true);
+		CHECK_EQ(mc::has_single_bit(0u), false);
+		CHECK_EQ(mc::has_single_bit(65u), false);
+
+		CHECK_EQ(mc::bit_width(0u), 0);
+		CHECK_EQ(mc::bit_width(1u), 1);
+		CHECK_EQ(mc::bit_width(255u), 8);
+
+		CHECK_EQ(mc::bit_ceil(0u), 1);
+		CHECK_EQ(mc::bit_ceil(1u), 1);
+		CHECK_EQ(mc::bit_ceil(17u), 32);
+		CHECK_EQ(mc::bit_ceil(uint8_t(128)), 128);
+		CHECK_EQ(mc::bit_floor(0u), 0);
+		CHECK_EQ(mc::bit_floor(17u), 16);
+		CHECK_EQ(mc::bit_floor(UINT64_MAX), uint64_t(1) << 63);
+	}
+
+	TEST(rotate_swap)
+	{
+		CHECK_EQ(mc::rotl(uint8_t(0x81), 1), 0x03);
+		CHECK_EQ(mc::rotr(uint8_t(0x81), 1), 0xc0);
+		CHECK_EQ(mc::rotl(0x80000001u, 4), 0x18u);
+		CHECK_EQ(mc::rotl(0x12345678u, -8), 0x78123456u);
+		CHECK_EQ(mc::rotr(uint64_t(1), 1), uint64_t(1) << 63);
+		CHECK_EQ(mc::rotl(0x12345678u, 32), 0x12345678u);
+
+		CHECK_EQ(mc::byteswap(uint16_t(0x1234)), 0x3412);
+		CHECK_EQ(mc::byteswap(0x12345678u), 0x78563412u);
+		CHECK_EQ(mc::byteswap(uint64_t(0x0102030405060708)),
+		         uint64_t(0x0807060504030201));
+
+		CHECK_EQ(mc::bit_cast<uint32_t>(1.f), 0x3f800000u);
+	}
+
+	TEST(load_store)
+	{
+		uint8_t buf[9] {0, 1, 2, 3, 4, 5, 6, 7, 8};
+		CHECK_EQ(mc::load_little_endian<uint32_t>(buf + 1), 0x04030201u);
+		CHECK_EQ(mc::load_big_endian<uint32_t>(buf + 1), 0x01020304u);
+		CHECK_EQ(mc::load_big_endian<uint16_t>(buf + 7), 0x0708);
+
+		mc::store_big_endian(buf + 3, uint32_t(0xaabbccdd));
+		CHECK_EQ(buf[3], 0xaa);
+		CHECK_EQ(buf[6], 0xdd);
+		mc::store_little_endian(buf + 3, uint16_t(0x1122));
+		CHECK_EQ(buf[3], 0x22);
+		CHECK_EQ(buf[4], 0x11);
+
+		mc::store_unaligned(buf + 1, uint32_t(0));
+		CHECK_EQ(mc::load_unaligned<uint32_t>(buf + 1), 0);
+		CHECK_EQ(buf[0], 0);
+		CHECK_EQ(buf[7], 7);
+	}
+}
@@ -0,0 +1,173 @@
+#include "unit.hh"
+
+#include <bit_vector.hh>
+#include <bitset.hh>
+#include <vector.hh>
+
+GROUP(bitset)
+{
+	TEST(bits)
+	{
+		mc::bitset<130> set;
+		CHECK_EQ(set.size(), 130);
+		CHECK_EQ(set.none(), true);
+
+		set.set(0);
+		set.set(64, true);
+		set.set(129);
+		set.flip(3);
+		CHECK_EQ(set.count(), 4);
+		CHECK_EQ(set[64], true);
+		CHECK_EQ(set.test(3), true);
+
+		set.reset(3);
+		set.flip(0);
+		set.set(64, false);
+		CHECK_EQ(set.count(), 1);
+		CHECK_EQ(set.find_first(), 129);
+
+		set.flip_all();
+		CHECK_EQ(set.count(), 129);
+		CHECK_EQ(set.test(129), false);
+		set.set(129);
+		CHECK_EQ(set.all(), true);
+	}
+
+	TEST(range)
+	{
+		mc::bitset<200> set;
+		set.set_range(60, 80);
+		CHECK_EQ(set.count(), 80);
+		CHECK_EQ(set.test(59), false);
+		CHECK_EQ(set.test(60), true);
+		CHECK_EQ(set.test(139), true);
+		CHECK_EQ(set.test(140), false);
+
+		set.reset_range(62, 2);
+		CHECK_EQ(set.count(), 78);
+		CHECK_EQ(set.find_next(62), 64);
+
+		set.set_all();
+		CHECK_EQ(set.count(), 200);
+		set.reset_all();
+		CHECK_EQ(set.any(), false);
+	}
+
+	TEST(find)
+	{
+		mc::bitset<300> set;
+		CHECK_EQ(set.find_first(), UINT32_MAX);
+
+		uint32_t idxs[] {1, 63, 64, 200, 299};
+		for (uint32_t idx : idxs)
+			set.set(idx);
+
+		CHECK_EQ(set.find_next(2), 63);
+		CHECK_EQ(set.find_next(65), 200);
+		CHECK_EQ(set.find_next(299), 299);
+		CHECK_EQ(set.find_next(300), UINT32_MAX);
+
+		mc::vector<uint32_t> found;
+		set.for_each_set([&](uint32_t idx) { found.emplace_back(idx); });
+		CHECK_EQ(found.size(), 5);
+		for (uint32_t i {0}; i < 5; ++i)
+			CHECK_EQ(found[i], idxs[i]);
+	}
+
+	TEST(ops)
+	{
+		// Enough words for full SIMD registers and a tail.
+		mc::bitset<1000> lhs, rhs;
+		lhs.set_range(0, 600);
+		rhs.set_range(400, 600);
+
+		mc::bitset<1000> res = lhs;
+		res &= rhs;
+		CHECK_EQ(res.count(), 200);
+		CHECK_EQ(res.find_first(), 400);
+
+		res = lhs;
+		res |= rhs;
+		CHECK_EQ(res.all(), true);
+
+		res = lhs;
+		res ^= rhs;
+		CHECK_EQ(res.count(), 800);
+		CHECK_EQ(res.test(500), false);
+
+		res = lhs;
+		res.and_not(rhs);
+		CHECK_EQ(res.count(), 400);
+		CHECK_EQ(res.find_next(400), UINT32_MAX);
+
+		CHECK_EQ(res == lhs, false);
+		lhs.reset_range(400, 200);
+		CHECK_EQ(res == lhs, true);
+		CHECK_EQ(res.words().size(), 16);
+	}
+}
+
+GROUP(bit_vector)
+{
+	TEST(grow)
+	{
+		mc::bit_vector vec;
+		CHECK_EQ(vec.empty(), true);
+		CHECK_EQ(vec.find_first(), UINT32_MAX);
+
+		for (uint32_t i {0}; i < 150; ++i)
+			vec.push_back(i % 3 == 0);
+		CHECK_EQ(vec.size(), 150);
+		CHECK_EQ(vec.capacity() >= 150, true);
+		CHECK_EQ(vec.count(), 50);
+		CHECK_EQ(vec.find_next(1), 3);
+
+		for (uint32_t i {0}; i < 22; ++i)
+			vec.pop_back();
+		CHECK_EQ(vec.size(), 128);
+		CHECK_EQ(vec.words().size(), 2);
+		CHECK_EQ(vec.count(), 43);
+
+		vec.resize(200, true);
+		CHECK_EQ(vec.count(), 43 + 72);
+		CHECK_EQ(vec.test(199), true);
+
+		vec.resize(10);
+		CHECK_EQ(vec.count(), 4);
+		vec.resize(70);
+		CHECK_EQ(vec.count(), 4);
+
+		vec.flip_all();
+		CHECK_EQ(vec.count(), 66);
+		vec.clear();
+		CHECK_EQ(vec.size(), 0);
+	}
+
+	TEST(ops)
+	{
+		mc::bit_vector lhs(700), rhs(700, true);
+		CHECK_EQ(rhs.all(), true);
+		CHECK_EQ(rhs.count(), 700);
+
+		lhs.set_range(100, 100);
+		rhs.reset_range(150, 500);
+		mc::bit_vector res = lhs;
+		res &= rhs;
+		CHECK_EQ(res.count(), 50);
+		res |= rhs;
+		CHECK_EQ(res.count(), 200);
+		res ^= lhs;
+		CHECK_EQ(res.count(), 200);
+		res.and_not(rhs);
+		CHECK_EQ(res.count(), 50);
+		CHECK_EQ(res.find_first(), 150);
+
+		uint32_t sum {0};
+		lhs.for_each_set([&](uint32_t idx) { sum += idx; });
+		CHECK_EQ(sum, (100 + 199) * 50);
+
+		CHECK_EQ(lhs == lhs, true);
+		CHECK_EQ(lhs == rhs, false);
+		CHECK_EQ(mc::bit_vector() == mc::bit_vector(), true);
+	}
+}
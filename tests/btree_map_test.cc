@@ -0,0 +1,220 @@
+#include "unit.hh"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <btree_map.hh>
+#include <flat_map.hh>
+#include <string.hh>
+
+GROUP(btree_map)
+{
+	uint32_t next_random(uint32_t& state)
+	{
+		state = state * 1664525 + 1013904223;
+		return state >> 8;
+	}
+
+	template <typename K, typename V>
+	bool same_content(mc::btree_map<K, V> const& bm, mc::flat_map<K, V> const& fm)
+	{
+		if (bm.size() != fm.size())
+			return false;
+
+		bool     res {true};
+		uint32_t idx {0};
+		bm.for_each([&](K const& key, V const& val) {
+			res &= idx < fm.size() && key == fm.key_at(idx) && val == fm.value_at(idx);
+			++idx;
+		});
+
+		return res && idx == fm.size();
+	}
+
+	TEST(insert_find)
+	{
+		mc::btree_map<uint32_t, uint32_t> bm0;
+		CHECK_EQ(bm0.empty(), true);
+		CHECK_EQ(bm0.find(1), nullptr);
+		CHECK_EQ(bm0.first().valid(), false);
+
+		mc::pair<uint32_t*, bool> res0 = bm0.insert(5, 50);
+		CHECK_EQ(*res0.first, 50);
+		CHECK_EQ(res0.second, true);
+
+		mc::pair<uint32_t*, bool> res1 = bm0.insert(5, 51);
+		CHECK_EQ(*res1.first, 50);
+		CHECK_EQ(res1.second, false);
+
+		mc::pair<uint32_t*, bool> res2 = bm0.insert_or_assign(5, 52);
+		CHECK_EQ(*res2.first, 52);
+		CHECK_EQ(res2.second, false);
+
+		bm0[7] = 70;
+		bm0[7] += 1;
+		CHECK_EQ(*bm0.find(7), 71);
+		CHECK_EQ(bm0.contains(6), false);
+		CHECK_EQ(bm0.size(), 2);
+
+		// Enough entries for a tree of several levels, in pseudo random order.
+		mc::btree_map<uint32_t, uint32_t> bm1;
+		mc::flat_map<uint32_t, uint32_t>  fm1;
+		uint32_t                          state = 42;
+		for (uint32_t i {0}; i < 20000; ++i)
+		{
+			uint32_t key = next_random(state) % 50000;
+			bm1.insert(key, i);
+			fm1.insert(key, i);
+		}
+		CHECK_EQ(same_content(bm1, fm1), true);
+
+		bool res {true};
+		for (uint32_t i {0}; i < 50000; ++i)
+		{
+			uint32_t const* val = bm1.find(i);
+			uint32_t const* ref = fm1.find(i);
+			res &= (val == nullptr) == (ref == nullptr);
+			if (val && ref)
+				res &= *val == *ref;
+		}
+		CHECK_EQ(res, true);
+	}
+
+	TEST(erase)
+	{
+		mc::btree_map<uint32_t, uint32_t> bm0;
+		mc::flat_map<uint32_t, uint32_t>  fm0;
+		uint32_t                          state = 7;
+		for (uint32_t i {0}; i < 10000; ++i)
+		{
+			uint32_t key = next_random(state) % 20000;
+			bm0.insert(key, key * 2);
+			fm0.insert(key, key * 2);
+		}
+
+		bool res {true};
+		for (uint32_t i {0}; i < 30000; ++i)
+		{
+			uint32_t key = next_random(state) % 20000;
+			res &= bm0.erase(key) == fm0.erase(key);
+			if (i % 3 == 0)
+			{
+				bm0.insert(key + 1, i);
+				fm0.insert(key + 1, i);
+			}
+		}
+		CHECK_EQ(res, true);
+		CHECK_EQ(same_content(bm0, fm0), true);
+
+		// Erase everything, in ascending order then descending order.
+		for (uint32_t i {0}; i < 20001; i += 2)
+			bm0.erase(i);
+		for (uint32_t i {20001}; i > 0; --i)
+			bm0.erase(i);
+		CHECK_EQ(bm0.size(), 0);
+		CHECK_EQ(bm0.empty(), true);
+		CHECK_EQ(bm0.first().valid(), false);
+
+		bm0.insert(1, 1);
+		CHECK_EQ(bm0.size(), 1);
+		CHECK_EQ(*bm0.find(1), 1);
+	}
+
+	TEST(cursor)
+	{
+		mc::btree_map<uint32_t, uint32_t> bm0;
+		for (uint32_t i {0}; i < 1000; ++i)
+			bm0.insert(i * 10, i);
+
+		mc::btree_map<uint32_t, uint32_t>::cursor it0 = bm0.lower_bound(95);
+		CHECK_EQ(it0.valid(), true);
+		CHECK_EQ(it0.key(), 100);
+		it0.prev();
+		CHECK_EQ(it0.key(), 90);
+
+		mc::btree_map<uint32_t, uint32_t>::cursor it1 = bm0.upper_bound(100);
+		CHECK_EQ(it1.key(), 110);
+		it1.value() = 0;
+		CHECK_EQ(*bm0.find(110), 0);
+
+		mc::btree_map<uint32_t, uint32_t>::cursor it2 = bm0.lower_bound(9991);
+		CHECK_EQ(it2.valid(), false);
+
+		uint32_t count {0};
+		bool     res {true};
+		for (auto it = bm0.first(); it.valid(); it.next())
+		{
+			res &= it.key() == count * 10;
+			++count;
+		}
+		CHECK_EQ(res, true);
+		CHECK_EQ(count, 1000);
+
+		count = 0;
+		for (auto it = bm0.last(); it.valid(); it.prev())
+			++count;
+		CHECK_EQ(count, 1000);
+
+		mc::btree_map<uint32_t, uint32_t> const& bm1 = bm0;
+		mc::btree_map<uint32_t, uint32_t>::const_cursor it3 = bm1.lower_bound(500);
+		CHECK_EQ(it3.value(), 50);
+	}
+
+	TEST(range)
+	{
+		mc::btree_map<uint32_t, uint32_t> bm0;
+		for (uint32_t i {0}; i < 1000; ++i)
+			bm0.insert(i, i);
+
+		uint32_t sum {0};
+		uint32_t count {0};
+		bm0.for_each(100, 200, [&](uint32_t const& key, uint32_t& val) {
+			sum += key;
+			++count;
+			val = 0;
+		});
+		CHECK_EQ(count, 100);
+		CHECK_EQ(sum, 14950);
+		CHECK_EQ(*bm0.find(150), 0);
+		CHECK_EQ(*bm0.find(200), 200);
+
+		count = 0;
+		bm0.for_each(2000, 3000, [&](uint32_t const&, uint32_t&) { ++count; });
+		CHECK_EQ(count, 0);
+	}
+
+	TEST(copy_move)
+	{
+		mc::btree_map<mc::string, uint32_t> bm0;
+		mc::flat_map<mc::string, uint32_t>  fm0;
+		char                                buf[32];
+		for (uint32_t i {0}; i < 2000; ++i)
+		{
+			snprintf(buf, sizeof(buf), "a long key to spill %u", i * 7919 % 2000);
+			bm0.insert(buf, i);
+			fm0.insert(buf, i);
+		}
+		for (uint32_t i {0}; i < 2000; i += 3)
+		{
+			snprintf(buf, sizeof(buf), "a long key to spill %u", i);
+			bm0.erase(buf);
+			fm0.erase(buf);
+		}
+		CHECK_EQ(same_content(bm0, fm0), true);
+
+		mc::btree_map<mc::string, uint32_t> bm1(bm0);
+		CHECK_EQ(same_content(bm1, fm0), true);
+
+		mc::btree_map<mc::string, uint32_t> bm2(static_cast<decltype(bm1)&&>(bm1));
+		CHECK_EQ(bm1.empty(), true);
+		CHECK_EQ(same_content(bm2, fm0), true);
+
+		bm1 = bm2;
+		CHECK_EQ(same_content(bm1, fm0), true);
+		CHECK_EQ(bm1.last().key() == fm0.keys().back(), true);
+
+		bm2.clear();
+		bm1 = static_cast<decltype(bm2)&&>(bm2);
+		CHECK_EQ(bm1.empty(), true);
+	}
+}
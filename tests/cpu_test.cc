@@ -0,0 +1,48 @@
+#include "unit.hh"
+
+#include <cpu.hh>
+
+GROUP(cpu)
+{
+	uint32_t g_resolve_count {0};
+
+	uint32_t add_generic(uint32_t lhs, uint32_t rhs)
+	{
+		return lhs + rhs;
+	}
+
+	uint32_t add_other(uint32_t lhs, uint32_t rhs)
+	{
+		return rhs + lhs;
+	}
+
+	mc::dispatched<uint32_t(uint32_t, uint32_t)> add {[]() {
+		++g_resolve_count;
+		return mc::cpu_supports(mc::cpu_feature::avx2) ? &add_other : &add_generic;
+	}};
+
+	TEST(features)
+	{
+		CHECK_EQ(mc::cpu_features(), mc::cpu_features());
+#if defined(__x86_64__)
+		CHECK_EQ(mc::cpu_supports(mc::cpu_feature::sse2), true);
+		CHECK_EQ(mc::cpu_supports(mc::cpu_feature::neon), false);
+#elif defined(__aarch64__)
+		CHECK_EQ(mc::cpu_supports(mc::cpu_feature::neon), true);
+		CHECK_EQ(mc::cpu_supports(mc::cpu_feature::sse2), false);
+#endif
+		// Extensions imply their predecessors.
+		if (mc::cpu_supports(mc::cpu_feature::avx2))
+			CHECK_EQ(mc::cpu_supports(mc::cpu_feature::avx), true);
+		if (mc::cpu_supports(mc::cpu_feature::avx512bw))
+			CHECK_EQ(mc::cpu_supports(mc::cpu_feature::avx512f), true);
+	}
+
+	TEST(dispatched)
+	{
+		CHECK_EQ(add(1, 2), 3);
+		CHECK_EQ(add(3, 4), 7);
+		CHECK_EQ(g_resolve_count, 1);
+		CHECK_EQ(add.get() == &add_generic || add.get() == &add_other, true);
+	}
+}
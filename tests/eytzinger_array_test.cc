@@ -0,0 +1,84 @@
+#include "unit.hh"
+
+#include <stdint.h>
+
+#include <eytzinger_array.hh>
+#include <vector.hh>
+
+GROUP(eytzinger_array)
+{
+	TEST(ctor)
+	{
+		mc::eytzinger_array<uint32_t> ea0;
+		CHECK_EQ(ea0.empty(), true);
+		CHECK_EQ(ea0.size(), 0);
+		CHECK_EQ(ea0.data(), nullptr);
+		CHECK_EQ(ea0.lower_bound(1), nullptr);
+
+		uint32_t                      arr[7] {1, 2, 3, 4, 5, 6, 7};
+		mc::eytzinger_array<uint32_t> ea1(arr);
+		CHECK_EQ(ea1.empty(), false);
+		CHECK_EQ(ea1.size(), 7);
+
+		uint32_t bfs[7] {4, 2, 6, 1, 3, 5, 7};
+		bool     res {true};
+		for (uint32_t i {0}; i < 7; ++i)
+			res &= ea1.data()[i] == bfs[i];
+		CHECK_EQ(res, true);
+	}
+
+	TEST(lower_bound)
+	{
+		uint32_t                      arr[8] {1, 3, 3, 3, 5, 8, 13, 21};
+		mc::eytzinger_array<uint32_t> ea0(arr);
+
+		CHECK_EQ(*ea0.lower_bound(0), 1);
+		CHECK_EQ(*ea0.lower_bound(3), 3);
+		CHECK_EQ(*ea0.lower_bound(4), 5);
+		CHECK_EQ(*ea0.lower_bound(21), 21);
+		CHECK_EQ(ea0.lower_bound(22), nullptr);
+
+		// Check every size, to cover all the incomplete tree shapes.
+		bool res {true};
+		for (uint32_t size {1}; size < 70; ++size)
+		{
+			mc::vector<uint32_t> vec;
+			for (uint32_t i {0}; i < size; ++i)
+				vec.emplace_back(i * 2);
+
+			mc::eytzinger_array<uint32_t> ea1(vec);
+			res &= ea1.size() == size;
+			for (uint32_t i {0}; i < size * 2 - 1; ++i)
+				res &= *ea1.lower_bound(i) == (i + 1) / 2 * 2;
+			res &= ea1.lower_bound(size * 2 - 1) == nullptr;
+		}
+		CHECK_EQ(res, true);
+	}
+
+	TEST(upper_bound)
+	{
+		uint32_t                      arr[8] {1, 3, 3, 3, 5, 8, 13, 21};
+		mc::eytzinger_array<uint32_t> ea0(arr);
+
+		CHECK_EQ(*ea0.upper_bound(0), 1);
+		CHECK_EQ(*ea0.upper_bound(1), 3);
+		CHECK_EQ(*ea0.upper_bound(3), 5);
+		CHECK_EQ(*ea0.upper_bound(13), 21);
+		CHECK_EQ(ea0.upper_bound(21), nullptr);
+	}
+
+	TEST(find)
+	{
+		uint32_t                      arr[8] {1, 3, 3, 3, 5, 8, 13, 21};
+		mc::eytzinger_array<uint32_t> ea0(arr);
+
+		CHECK_EQ(*ea0.find(8), 8);
+		CHECK_EQ(ea0.find(9), nullptr);
+		CHECK_EQ(ea0.find(30), nullptr);
+
+		CHECK_EQ(ea0.contains(1), true);
+		CHECK_EQ(ea0.contains(21), true);
+		CHECK_EQ(ea0.contains(0), false);
+		CHECK_EQ(ea0.contains(4), false);
+	}
+}
@@ -0,0 +1,112 @@
+#include "unit.hh"
+
+#include <stdint.h>
+
+#include <flat_map.hh>
+#include <string_view.hh>
+
+GROUP(flat_map)
+{
+	TEST(ctor)
+	{
+		mc::flat_map<uint32_t, uint32_t> fm0;
+		CHECK_EQ(fm0.empty(), true);
+		CHECK_EQ(fm0.size(), 0);
+		CHECK_EQ(fm0.find(1), nullptr);
+
+		uint32_t keys[6] {5, 3, 9, 3, 1, 5};
+		uint32_t values[6] {50, 30, 90, 31, 10, 51};
+
+		mc::flat_map<uint32_t, uint32_t> fm1(keys, values);
+		CHECK_EQ(fm1.size(), 4);
+		CHECK_EQ(fm1.key_at(0), 1);
+		CHECK_EQ(fm1.key_at(1), 3);
+		CHECK_EQ(fm1.key_at(2), 5);
+		CHECK_EQ(fm1.key_at(3), 9);
+		// First occurrence is kept
+		CHECK_EQ(fm1.value_at(1), 30);
+		CHECK_EQ(fm1.value_at(2), 50);
+
+		mc::flat_map<mc::string_view, uint32_t> fm2(
+			{{"post", 2}, {"get", 1}, {"put", 3}, {"delete", 4}});
+		CHECK_EQ(fm2.size(), 4);
+		CHECK_EQ(*fm2.find("get"), 1);
+		CHECK_EQ(*fm2.find("put"), 3);
+		CHECK_EQ(fm2.find("patch"), nullptr);
+		CHECK_EQ(fm2.keys()[0] == "delete", true);
+	}
+
+	TEST(lookup)
+	{
+		uint32_t keys[4] {10, 20, 30, 40};
+		uint32_t values[4] {1, 2, 3, 4};
+
+		mc::flat_map<uint32_t, uint32_t> fm0(keys, values);
+		CHECK_EQ(fm0.lower_bound(5), 0);
+		CHECK_EQ(fm0.lower_bound(20), 1);
+		CHECK_EQ(fm0.lower_bound(25), 2);
+		CHECK_EQ(fm0.lower_bound(45), 4);
+
+		CHECK_EQ(fm0.index_of(30), 2);
+		CHECK_EQ(fm0.index_of(35), UINT32_MAX);
+
+		CHECK_EQ(fm0.contains(40), true);
+		CHECK_EQ(fm0.contains(0), false);
+
+		*fm0.find(10) = 100;
+		CHECK_EQ(fm0.values()[0], 100);
+	}
+
+	TEST(insert)
+	{
+		mc::flat_map<uint32_t, uint32_t> fm0;
+
+		mc::pair<uint32_t, bool> res0 = fm0.insert(5, 50);
+		CHECK_EQ(res0.first, 0);
+		CHECK_EQ(res0.second, true);
+
+		mc::pair<uint32_t, bool> res1 = fm0.insert(1, 10);
+		CHECK_EQ(res1.first, 0);
+		CHECK_EQ(res1.second, true);
+
+		mc::pair<uint32_t, bool> res2 = fm0.insert(5, 51);
+		CHECK_EQ(res2.first, 1);
+		CHECK_EQ(res2.second, false);
+		CHECK_EQ(fm0.value_at(1), 50);
+
+		mc::pair<uint32_t, bool> res3 = fm0.insert_or_assign(5, 52);
+		CHECK_EQ(res3.first, 1);
+		CHECK_EQ(res3.second, false);
+		CHECK_EQ(fm0.value_at(1), 52);
+
+		mc::pair<uint32_t, bool> res4 = fm0.insert_or_assign(3, 30);
+		CHECK_EQ(res4.first, 1);
+		CHECK_EQ(res4.second, true);
+
+		fm0[7] = 70;
+		fm0[3] += 3;
+		CHECK_EQ(fm0.size(), 4);
+		CHECK_EQ(*fm0.find(7), 70);
+		CHECK_EQ(*fm0.find(3), 33);
+	}
+
+	TEST(erase)
+	{
+		uint32_t keys[4] {10, 20, 30, 40};
+		uint32_t values[4] {1, 2, 3, 4};
+
+		mc::flat_map<uint32_t, uint32_t> fm0(keys, values);
+		CHECK_EQ(fm0.erase(20), true);
+		CHECK_EQ(fm0.erase(20), false);
+		CHECK_EQ(fm0.size(), 3);
+		CHECK_EQ(fm0.key_at(1), 30);
+		CHECK_EQ(fm0.value_at(1), 3);
+
+		fm0.erase_at(0);
+		CHECK_EQ(fm0.size(), 2);
+		CHECK_EQ(fm0.key_at(0), 30);
+
+		fm0.clear();
+		CHECK_EQ(fm0.empty(), true);
+	}
+}
@@ -0,0 +1,69 @@
+#include "unit.hh"
+
+#include <stdint.h>
+
+#include <flat_set.hh>
+
+GROUP(flat_set)
+{
+	TEST(ctor)
+	{
+		mc::flat_set<uint32_t> fs0;
+		CHECK_EQ(fs0.empty(), true);
+		CHECK_EQ(fs0.contains(0), false);
+
+		mc::flat_set<uint32_t> fs1({7, 3, 3, 9, 1, 7, 7});
+		CHECK_EQ(fs1.size(), 4);
+		CHECK_EQ(fs1[0], 1);
+		CHECK_EQ(fs1[1], 3);
+		CHECK_EQ(fs1[2], 7);
+		CHECK_EQ(fs1[3], 9);
+
+		mc::array_view<uint32_t> av0 = fs1;
+		CHECK_EQ(av0.size(), 4);
+		CHECK_EQ(av0.data(), fs1.data());
+
+		mc::flat_set<uint32_t, mc::greater<uint32_t>> fs2({7, 3, 9, 1});
+		CHECK_EQ(fs2[0], 9);
+		CHECK_EQ(fs2[3], 1);
+		CHECK_EQ(fs2.contains(3), true);
+	}
+
+	TEST(lookup)
+	{
+		mc::flat_set<uint32_t> fs0({10, 20, 30, 40});
+
+		CHECK_EQ(fs0.lower_bound(15), 1);
+		CHECK_EQ(fs0.index_of(30), 2);
+		CHECK_EQ(fs0.index_of(31), UINT32_MAX);
+		CHECK_EQ(fs0.contains(10), true);
+		CHECK_EQ(fs0.contains(50), false);
+	}
+
+	TEST(insert_erase)
+	{
+		mc::flat_set<uint32_t> fs0;
+
+		mc::pair<uint32_t, bool> res0 = fs0.insert(5);
+		CHECK_EQ(res0.first, 0);
+		CHECK_EQ(res0.second, true);
+
+		fs0.insert(1);
+		fs0.insert(9);
+		mc::pair<uint32_t, bool> res1 = fs0.insert(5);
+		CHECK_EQ(res1.first, 1);
+		CHECK_EQ(res1.second, false);
+		CHECK_EQ(fs0.size(), 3);
+
+		CHECK_EQ(fs0.erase(5), true);
+		CHECK_EQ(fs0.erase(5), false);
+		CHECK_EQ(fs0.size(), 2);
+		CHECK_EQ(fs0[1], 9);
+
+		fs0.erase_at(0);
+		CHECK_EQ(fs0[0], 9);
+
+		fs0.clear();
+		CHECK_EQ(fs0.empty(), true);
+	}
+}
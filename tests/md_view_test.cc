@@ -0,0 +1,94 @@
+#include "unit.hh"
+
+#include <md_view.hh>
+#include <vector.hh>
+
+GROUP(md_view)
+{
+	float sum(mc::span<float> sp)
+	{
+		float res {0};
+		for (uint32_t i {0}; i < sp.size(); ++i)
+			res += sp[i];
+
+		return res;
+	}
+
+	TEST(matrix)
+	{
+		// 3 rows, 4 columns, values are row * 10 + col.
+		mc::vector<float> vec0;
+		for (uint32_t r {0}; r < 3; ++r)
+			for (uint32_t c {0}; c < 4; ++c)
+				vec0.emplace_back(r * 10 + c);
+
+		mc::md_view<float, 2> mat(vec0.data(), {3, 4});
+		CHECK_EQ(mat.extent(0), 3);
+		CHECK_EQ(mat.extent(1), 4);
+		CHECK_EQ(mat.stride(0), 4);
+		CHECK_EQ(mat.stride(1), 1);
+		CHECK_EQ(mat.size(), 12);
+		CHECK_EQ(mat.contiguous(), true);
+		CHECK_EQ(mat.flat().size(), 12);
+
+		CHECK_EQ(mat(0, 0), 0);
+		CHECK_EQ(mat(2, 3), 23);
+		CHECK_EQ(mat[1][2], 12);
+		CHECK_EQ(sum(mat.row(1)), 10 + 11 + 12 + 13);
+
+		mc::strided_view<float> col = mat.col(2);
+		CHECK_EQ(col.size(), 3);
+		CHECK_EQ(col[0], 2);
+		CHECK_EQ(col[1], 12);
+		CHECK_EQ(col[2], 22);
+
+		col[1] = -1;
+		CHECK_EQ(vec0[6], -1);
+	}
+
+	TEST(subview)
+	{
+		uint32_t arr0[4][5];
+		for (uint32_t r {0}; r < 4; ++r)
+			for (uint32_t c {0}; c < 5; ++c)
+				arr0[r][c] = r * 10 + c;
+
+		mc::md_view<uint32_t, 2> mat(arr0);
+		CHECK_EQ(mat.extent(0), 4);
+		CHECK_EQ(mat.extent(1), 5);
+
+		// 2x3 tile at (1, 2), keeping the stride of the whole matrix.
+		mc::md_view<uint32_t, 2> tile = mat.subview({1, 2}, {2, 3});
+		CHECK_EQ(tile.contiguous(), false);
+		CHECK_EQ(tile.stride(0), 5);
+		CHECK_EQ(tile(0, 0), 12);
+		CHECK_EQ(tile(1, 2), 24);
+		CHECK_EQ(tile.row(1).size(), 3);
+		CHECK_EQ(tile.col(1)[1], 23);
+
+		// Same tile from its pitch.
+		mc::md_view<uint32_t const, 2> tile2(&arr0[1][2], {2, 3}, {5});
+		CHECK_EQ(tile2(1, 0), 22);
+	}
+
+	TEST(volume)
+	{
+		uint32_t arr0[2][3][4];
+		for (uint32_t d {0}; d < 2; ++d)
+			for (uint32_t r {0}; r < 3; ++r)
+				for (uint32_t c {0}; c < 4; ++c)
+					arr0[d][r][c] = d * 100 + r * 10 + c;
+
+		mc::md_view<uint32_t, 3> vol(arr0);
+		CHECK_EQ(vol.size(), 24);
+		CHECK_EQ(vol.stride(0), 12);
+		CHECK_EQ(vol.stride(1), 4);
+		CHECK_EQ(vol(1, 2, 3), 123);
+
+		mc::md_view<uint32_t, 2> slice = vol[1];
+		CHECK_EQ(slice.extent(0), 3);
+		CHECK_EQ(slice.extent(1), 4);
+		CHECK_EQ(slice(2, 1), 121);
+		CHECK_EQ(slice.contiguous(), true);
+	}
+}
@@ -0,0 +1,113 @@
+#include "unit.hh"
+
+#include <stdint.h>
+
+#include <priority_queue.hh>
+
+GROUP(priority_queue)
+{
+	TEST(push_pop)
+	{
+		mc::priority_queue<uint32_t> pq0;
+		CHECK_EQ(pq0.empty(), true);
+
+		uint32_t vals[10] {5, 9, 1, 7, 3, 8, 2, 6, 4, 0};
+		for (uint32_t i {0}; i < 10; ++i)
+			pq0.push(vals[i]);
+		CHECK_EQ(pq0.size(), 10);
+		CHECK_EQ(pq0.top(), 9);
+
+		bool res {true};
+		for (uint32_t i {10}; i > 0; --i)
+		{
+			res &= pq0.top() == i - 1;
+			pq0.pop();
+		}
+		CHECK_EQ(res, true);
+		CHECK_EQ(pq0.empty(), true);
+
+		mc::priority_queue<uint32_t, mc::greater<uint32_t>, 2> pq1;
+		for (uint32_t i {0}; i < 10; ++i)
+			pq1.emplace(vals[i]);
+		CHECK_EQ(pq1.top(), 0);
+
+		res = true;
+		for (uint32_t i {0}; i < 10; ++i)
+		{
+			res &= pq1.top() == i;
+			pq1.pop();
+		}
+		CHECK_EQ(res, true);
+	}
+
+	TEST(heapify)
+	{
+		mc::vector<uint32_t> vec0;
+		uint32_t             state = 1;
+		for (uint32_t i {0}; i < 1000; ++i)
+		{
+			state = state * 1664525 + 1013904223;
+			vec0.emplace_back((state >> 8) % 500);
+		}
+
+		mc::priority_queue<uint32_t, mc::greater<uint32_t>> pq0(vec0);
+		CHECK_EQ(pq0.size(), 1000);
+
+		bool     res {true};
+		uint32_t prev = 0;
+		while (!pq0.empty())
+		{
+			res &= pq0.top() >= prev;
+			prev = pq0.top();
+			pq0.pop();
+		}
+		CHECK_EQ(res, true);
+	}
+
+	TEST(indexed)
+	{
+		mc::indexed_priority_queue<uint32_t, mc::greater<uint32_t>> pq0(8);
+		CHECK_EQ(pq0.empty(), true);
+		CHECK_EQ(pq0.key_count(), 8);
+
+		for (uint32_t i {0}; i < 8; ++i)
+			pq0.push(i, 100 + i);
+		CHECK_EQ(pq0.size(), 8);
+		CHECK_EQ(pq0.top_key(), 0);
+		CHECK_EQ(pq0.contains(5), true);
+
+		// Decrease key
+		pq0.update(5, 10);
+		CHECK_EQ(pq0.top_key(), 5);
+		CHECK_EQ(pq0.top(), 10);
+		CHECK_EQ(pq0.priority(5), 10);
+
+		// Increase key
+		pq0.update(5, 200);
+		CHECK_EQ(pq0.top_key(), 0);
+
+		CHECK_EQ(pq0.push_or_update(3, 1), false);
+		CHECK_EQ(pq0.top_key(), 3);
+
+		pq0.erase(3);
+		CHECK_EQ(pq0.contains(3), false);
+		CHECK_EQ(pq0.size(), 7);
+		CHECK_EQ(pq0.push_or_update(3, 50), true);
+
+		uint32_t order[8] {3, 0, 1, 2, 4, 6, 7, 5};
+		bool     res {true};
+		for (uint32_t i {0}; i < 8; ++i)
+		{
+			res &= pq0.top_key() == order[i];
+			pq0.pop();
+		}
+		CHECK_EQ(res, true);
+		CHECK_EQ(pq0.empty(), true);
+		CHECK_EQ(pq0.contains(0), false);
+
+		pq0.push(2, 5);
+		pq0.clear();
+		CHECK_EQ(pq0.empty(), true);
+		CHECK_EQ(pq0.contains(2), false);
+	}
+}
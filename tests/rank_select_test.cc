@@ -0,0 +1,77 @@
+#include "unit.hh"
+
+#include <bit_vector.hh>
+#include <rank_select.hh>
+#include <vector.hh>
+
+GROUP(rank_select)
+{
+	TEST(empty)
+	{
+		mc::rank_select rs;
+		CHECK_EQ(rs.empty(), true);
+
+		mc::rank_select built {mc::bit_vector()};
+		CHECK_EQ(built.count(), 0);
+		CHECK_EQ(built.rank(0), 0);
+		CHECK_EQ(built.select(0), UINT32_MAX);
+	}
+
+	TEST(words)
+	{
+		uint64_t words[] {0b1011, UINT64_MAX, uint64_t(1) << 63};
+		// The last word is cut, so its only set bit is ignored.
+		mc::rank_select rs {words, 130};
+		CHECK_EQ(rs.size(), 130);
+		CHECK_EQ(rs.count(), 67);
+		CHECK_EQ(rs.test(3), true);
+		CHECK_EQ(rs[2], false);
+
+		CHECK_EQ(rs.rank(0), 0);
+		CHECK_EQ(rs.rank(2), 2);
+		CHECK_EQ(rs.rank(4), 3);
+		CHECK_EQ(rs.rank(64), 3);
+		CHECK_EQ(rs.rank(100), 39);
+		CHECK_EQ(rs.rank(130), 67);
+		CHECK_EQ(rs.rank0(4), 1);
+
+		CHECK_EQ(rs.select(0), 0);
+		CHECK_EQ(rs.select(2), 3);
+		CHECK_EQ(rs.select(3), 64);
+		CHECK_EQ(rs.select(66), 127);
+		CHECK_EQ(rs.select(67), UINT32_MAX);
+	}
+
+	TEST(large)
+	{
+		// Several superblocks and select samples, with dense, sparse and empty parts.
+		uint32_t size {100000};
+		mc::bit_vector bits(size);
+		for (uint32_t i {0}; i < 30000; ++i)
+			bits.set(i);
+		for (uint32_t i {40000}; i < size; i += 7)
+			bits.set(i);
+
+		mc::rank_select rs {bits};
+		CHECK_EQ(rs.count(), bits.count());
+
+		mc::vector<uint32_t> ones;
+		bits.for_each_set([&](uint32_t idx) { ones.emplace_back(idx); });
+
+		bool rank_ok {true};
+		uint32_t rank {0};
+		for (uint32_t i {0}; i <= size; ++i)
+		{
+			rank_ok &= rs.rank(i) == rank;
+			if (i < size && bits[i])
+				++rank;
+		}
+		CHECK_EQ(rank_ok, true);
+
+		bool select_ok {true};
+		for (uint32_t k {0}; k < ones.size(); ++k)
+			select_ok &= rs.select(k) == ones[k];
+		CHECK_EQ(select_ok, true);
+		CHECK_EQ(rs.select(ones.size()), UINT32_MAX);
+	}
+}
@@ -0,0 +1,180 @@
+#include "unit.hh"
+
+#include <roaring_bitmap.hh>
+#include <vector.hh>
+
+GROUP(roaring_bitmap)
+{
+	TEST(add_remove)
+	{
+		mc::roaring_bitmap set;
+		CHECK_EQ(set.empty(), true);
+		CHECK_EQ(set.contains(3), false);
+
+		set.add(3);
+		set.add(3);
+		set.add(1 << 20);
+		set.add(UINT32_MAX);
+		CHECK_EQ(set.count(), 3);
+		CHECK_EQ(set.contains(3), true);
+		CHECK_EQ(set.contains(4), false);
+		CHECK_EQ(set.contains(UINT32_MAX), true);
+
+		set.remove(4);
+		set.remove(1 << 20);
+		CHECK_EQ(set.count(), 2);
+		CHECK_EQ(set.contains(1 << 20), false);
+
+		// Dense enough to turn into a bitmap, then back to an array.
+		for (uint32_t i {0}; i < 10000; ++i)
+			set.add(i * 2);
+		CHECK_EQ(set.count(), 10002);
+		CHECK_EQ(set.contains(19998), true);
+		CHECK_EQ(set.contains(19999), false);
+		for (uint32_t i {0}; i < 8000; ++i)
+			set.remove(i * 2);
+		CHECK_EQ(set.count(), 2002);
+		CHECK_EQ(set.contains(16000), true);
+		CHECK_EQ(set.contains(15998), false);
+
+		set.clear();
+		CHECK_EQ(set.empty(), true);
+	}
+
+	TEST(values)
+	{
+		uint32_t        values[] {70000, 5, 5, 1, 70000, 65536};
+		mc::roaring_bitmap set {values};
+		CHECK_EQ(set.count(), 4);
+
+		mc::vector<uint32_t> res = set.to_vector();
+		CHECK_EQ(res.size(), 4);
+		CHECK_EQ(res[0], 1);
+		CHECK_EQ(res[1], 5);
+		CHECK_EQ(res[2], 65536);
+		CHECK_EQ(res[3], 70000);
+	}
+
+	TEST(range)
+	{
+		mc::roaring_bitmap set;
+		set.add_range(65000, 200000);
+		CHECK_EQ(set.count(), 200000);
+		CHECK_EQ(set.contains(64999), false);
+		CHECK_EQ(set.contains(65000), true);
+		CHECK_EQ(set.contains(264999), true);
+		CHECK_EQ(set.contains(265000), false);
+
+		set.add(300000);
+		set.add(100000);
+		set.remove(131072);
+		CHECK_EQ(set.count(), 200000);
+		CHECK_EQ(set.contains(131072), false);
+
+		mc::roaring_bitmap copy = set;
+		copy.optimize();
+		CHECK_EQ(copy == set, true);
+		CHECK_EQ(copy.count(), 200000);
+		CHECK_EQ(copy.contains(131073), true);
+		CHECK_EQ(copy.contains(131072), false);
+
+		uint64_t sum {0}, expected {0};
+		copy.for_each([&](uint32_t val) { sum += val; });
+		set.for_each([&](uint32_t val) { expected += val; });
+		CHECK_EQ(sum, expected);
+	}
+
+	TEST(optimize)
+	{
+		// A single run stays a run, however many times it is optimized.
+		mc::roaring_bitmap full;
+		full.add_range(0, 65536);
+		full.optimize();
+		CHECK_EQ(full.memory_size(), 4);
+		full.optimize();
+		CHECK_EQ(full.memory_size(), 4);
+		CHECK_EQ(full.count(), 65536);
+
+		// Removing a value turns the run into a bitmap, optimize() splits it in two runs.
+		full.remove(1000);
+		CHECK_EQ(full.memory_size(), 8192);
+		full.optimize();
+		CHECK_EQ(full.memory_size(), 8);
+		CHECK_EQ(full.contains(1000), false);
+		CHECK_EQ(full.contains(1001), true);
+
+		// Isolated values are smaller as an array.
+		mc::roaring_bitmap sparse;
+		for (uint32_t i {0}; i < 100; ++i)
+			sparse.add(i * 10);
+		sparse.optimize();
+		CHECK_EQ(sparse.memory_size(), 200);
+		sparse.optimize();
+		CHECK_EQ(sparse.memory_size(), 200);
+	}
+
+	TEST(equal)
+	{
+		// Same count, different runs: [0, 4], [6, 10] against [0, 9].
+		mc::roaring_bitmap lhs, rhs;
+		lhs.add_range(0, 5);
+		lhs.add_range(6, 5);
+		rhs.add_range(0, 10);
+		lhs.optimize();
+		rhs.optimize();
+		CHECK_EQ(lhs.count(), rhs.count());
+		CHECK_EQ(lhs.memory_size(), 8);
+		CHECK_EQ(rhs.memory_size(), 4);
+		CHECK_EQ(lhs == rhs, false);
+		CHECK_EQ(rhs == lhs, false);
+
+		rhs.remove(5);
+		rhs.add(10);
+		rhs.optimize();
+		CHECK_EQ(lhs == rhs, true);
+	}
+
+	TEST(ops)
+	{
+		mc::roaring_bitmap evens, threes, range;
+		for (uint32_t i {0}; i < 200000; i += 2)
+			evens.add(i);
+		for (uint32_t i {0}; i < 200000; i += 3)
+			threes.add(i);
+		range.add_range(100000, 1000);
+		range.optimize();
+
+		mc::roaring_bitmap res = evens;
+		res &= threes;
+		uint64_t count {0};
+		bool     ok {true};
+		res.for_each([&](uint32_t val) {
+			ok &= val % 6 == 0;
+			++count;
+		});
+		CHECK_EQ(ok, true);
+		CHECK_EQ(count, (199998 / 6) + 1);
+		CHECK_EQ(res.count(), count);
+
+		res |= threes;
+		CHECK_EQ(res == threes, true);
+		res |= evens;
+		CHECK_EQ(res.count(), 100000 + 66667 - 33334);
+
+		res &= range;
+		CHECK_EQ(res.count(), 666);
+		CHECK_EQ(res.contains(100002), true);
+		CHECK_EQ(res.contains(100001), false);
+
+		// Sparse arrays, intersected 8 values at a time.
+		mc::roaring_bitmap lhs, rhs;
+		for (uint32_t i {0}; i < 1000; ++i)
+			lhs.add(i * 7);
+		for (uint32_t i {0}; i < 300; ++i)
+			rhs.add(i * 5);
+		lhs &= rhs;
+		CHECK_EQ(lhs.count(), 43);
+		lhs |= rhs;
+		CHECK_EQ(lhs == rhs, true);
+	}
+}
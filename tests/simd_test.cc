@@ -0,0 +1,107 @@
+#include "unit.hh"
+
+#include <simd.hh>
+
+GROUP(simd)
+{
+	TEST(load_store)
+	{
+		using vec = mc::simd<uint32_t, 4>;
+
+		alignas(16) uint32_t arr0[8] {0, 1, 2, 3, 4, 5, 6, 7};
+		vec                  v0 = vec::load(arr0 + 1);
+		for (uint32_t i {0}; i < 4; ++i)
+			CHECK_EQ(v0[i], i + 1);
+
+		vec v1 = vec::load_aligned(arr0 + 4);
+		CHECK_EQ(v1[0], 4);
+		CHECK_EQ(v1[3], 7);
+
+		vec v2 = vec::load_partial(arr0, 3, 42);
+		CHECK_EQ(v2[2], 2);
+		CHECK_EQ(v2[3], 42);
+
+		uint32_t arr1[4] {9, 9, 9, 9};
+		(v0 + v1).store_partial(arr1, 2);
+		CHECK_EQ(arr1[0], 5);
+		CHECK_EQ(arr1[1], 7);
+		CHECK_EQ(arr1[2], 9);
+
+		alignas(16) uint32_t arr2[4];
+		vec(3).store_aligned(arr2);
+		CHECK_EQ(arr2[0], 3);
+		CHECK_EQ(arr2[3], 3);
+	}
+
+	TEST(compare)
+	{
+		using vec = mc::simd<uint8_t, 16>;
+
+		char const* str = "0123456789abcdef";
+		vec         v0 = vec::load(reinterpret_cast<uint8_t const*>(str));
+		CHECK_EQ((v0 == vec('a')).bitmask(), 1u << 10);
+		CHECK_EQ((v0 < vec('2')).bitmask(), 0b11u);
+		CHECK_EQ((v0 >= vec('0')).all(), true);
+		CHECK_EQ((v0 == vec('z')).none(), true);
+		CHECK_EQ(((v0 == vec('0')) | (v0 == vec('f'))).bitmask(), 0x8001u);
+
+		using vec2 = mc::simd<float, 4>;
+		float val {0.f};
+		vec2  v1 = vec2::load_partial(&val, 0, 1.5f);
+		CHECK_EQ((v1 == vec2(1.5f)).all(), true);
+
+		using vec3 = mc::simd<uint8_t, 64>;
+		uint8_t arr0[64] {};
+		arr0[63] = 1;
+		CHECK_EQ((vec3::load(arr0) != vec3(0)).bitmask(), uint64_t(1) << 63);
+		CHECK_EQ((vec3::load(arr0) != vec3(0)).all(), false);
+		CHECK_EQ((vec3::load(arr0) < vec3(2)).all(), true);
+
+		// Bitmasks of 32 lanes fill their uint32_t.
+		using vec4 = mc::simd<uint16_t, 32>;
+		uint16_t arr1[32] {};
+		CHECK_EQ((vec4::load(arr1) == vec4(0)).all(), true);
+		CHECK_EQ((vec4::load(arr1) == vec4(0)).any(), true);
+		CHECK_EQ((vec4::load(arr1) != vec4(0)).any(), false);
+		arr1[31] = 1;
+		CHECK_EQ((vec4::load(arr1) == vec4(0)).all(), false);
+		CHECK_EQ((vec4::load(arr1) != vec4(0)).any(), true);
+		CHECK_EQ((vec4::load(arr1) != vec4(0)).bitmask(), uint32_t(1) << 31);
+
+		using vec5 = mc::simd<uint8_t, 32>;
+		uint8_t arr2[32] {};
+		CHECK_EQ((vec5::load(arr2) == vec5(0)).all(), true);
+		arr2[0] = 1;
+		CHECK_EQ((vec5::load(arr2) == vec5(0)).all(), false);
+	}
+
+	TEST(shuffle_reduce)
+	{
+		using vec = mc::simd<int32_t, 4>;
+
+		int32_t arr0[4] {4, -1, 7, 2};
+		vec     v0 = vec::load(arr0);
+		vec     v1 = v0.shuffle<3, 2, 1, 0>();
+		CHECK_EQ(v1[0], 2);
+		CHECK_EQ(v1[3], 4);
+		CHECK_EQ(v0.reverse()[1], 7);
+
+		CHECK_EQ(v0.reduce_add(), 12);
+		CHECK_EQ(v0.reduce_min(), -1);
+		CHECK_EQ(v0.reduce_max(), 7);
+
+		vec v2 = mc::min(v0, vec(3));
+		CHECK_EQ(v2[0], 3);
+		CHECK_EQ(v2[1], -1);
+		vec v3 = mc::max(v0, vec(3));
+		CHECK_EQ(v3[2], 7);
+		CHECK_EQ(v3[3], 3);
+
+		using vec2 = mc::simd<float, 4>;
+		vec2 v4 = mc::select(vec2(1.f) < vec2(2.f), vec2(0.5f), vec2(8.f));
+		CHECK_EQ(v4.reduce_add(), 2.f);
+
+		CHECK_EQ(((v0 << 1) >> 1)[1], -1);
+		CHECK_EQ((v0 & vec(1))[2], 1);
+	}
+}
@@ -0,0 +1,154 @@
+#include "unit.hh"
+
+#include <stdint.h>
+
+#include <sort.hh>
+#include <vector.hh>
+
+GROUP(sort)
+{
+	// Deterministic pseudo random values, with many duplicates.
+	mc::vector<uint32_t> random_values(uint32_t size, uint32_t range)
+	{
+		mc::vector<uint32_t> vec;
+		uint32_t             state = 12345;
+		for (uint32_t i {0}; i < size; ++i)
+		{
+			state = state * 1664525 + 1013904223;
+			vec.emplace_back((state >> 8) % range);
+		}
+
+		return vec;
+	}
+
+	bool is_sorted(uint32_t const* arr, uint32_t size)
+	{
+		for (uint32_t i {1}; i < size; ++i)
+			if (arr[i] < arr[i - 1])
+				return false;
+
+		return true;
+	}
+
+	TEST(sort)
+	{
+		uint32_t arr0[6] {5, 1, 4, 2, 3, 0};
+		mc::sort<uint32_t>(arr0);
+		CHECK_EQ(is_sorted(arr0, 6), true);
+
+		mc::vector<uint32_t> vec0 = random_values(5000, 1000);
+		mc::sort<uint32_t>(vec0);
+		CHECK_EQ(is_sorted(vec0.data(), vec0.size()), true);
+
+		mc::vector<uint32_t> vec1(1000, 7);
+		mc::sort<uint32_t>(vec1);
+		CHECK_EQ(is_sorted(vec1.data(), vec1.size()), true);
+
+		mc::vector<uint32_t> vec2;
+		for (uint32_t i {0}; i < 1000; ++i)
+			vec2.emplace_back(1000 - i);
+		mc::sort<uint32_t>(vec2, mc::greater<uint32_t>());
+		CHECK_EQ(vec2.front(), 1000);
+		CHECK_EQ(vec2.back(), 1);
+		mc::sort<uint32_t>(vec2);
+		CHECK_EQ(is_sorted(vec2.data(), vec2.size()), true);
+	}
+
+	TEST(nth_element)
+	{
+		for (uint32_t size : {1u, 10u, 17u, 100u, 5000u})
+		{
+			mc::vector<uint32_t> vec0 = random_values(size, 100);
+			mc::vector<uint32_t> sorted = vec0;
+			mc::sort<uint32_t>(sorted);
+
+			bool res {true};
+			for (uint32_t n : {0u, size / 4, size / 2, size - 1})
+			{
+				mc::vector<uint32_t> vec1 = vec0;
+				mc::nth_element<uint32_t>(vec1, n);
+				res &= vec1[n] == sorted[n];
+				for (uint32_t i {0}; i < n; ++i)
+					res &= vec1[i] <= vec1[n];
+				for (uint32_t i {n + 1}; i < size; ++i)
+					res &= vec1[i] >= vec1[n];
+			}
+			CHECK_EQ(res, true);
+		}
+	}
+
+	TEST(partial_sort)
+	{
+		mc::vector<uint32_t> vec0 = random_values(1000, 100000);
+		mc::vector<uint32_t> sorted = vec0;
+		mc::sort<uint32_t>(sorted);
+
+		mc::partial_sort<uint32_t>(vec0, 50);
+		bool res {true};
+		for (uint32_t i {0}; i < 50; ++i)
+			res &= vec0[i] == sorted[i];
+		CHECK_EQ(res, true);
+
+		uint32_t arr0[3] {3, 1, 2};
+		mc::partial_sort<uint32_t>(arr0, 10);
+		CHECK_EQ(arr0[0], 1);
+		CHECK_EQ(arr0[1], 2);
+		CHECK_EQ(arr0[2], 3);
+	}
+
+	TEST(top_k)
+	{
+		mc::vector<uint32_t> vec0 = random_values(1000, 100000);
+		mc::vector<uint32_t> sorted = vec0;
+		mc::sort<uint32_t>(sorted);
+
+		mc::vector<uint32_t> res0 = mc::top_k<uint32_t>(vec0, 10);
+		CHECK_EQ(res0.size(), 10);
+		bool res {true};
+		for (uint32_t i {0}; i < 10; ++i)
+			res &= res0[i] == sorted[i];
+		CHECK_EQ(res, true);
+
+		mc::vector<uint32_t> res1 =
+			mc::top_k<uint32_t>(vec0, 10, mc::greater<uint32_t>());
+		CHECK_EQ(res1.size(), 10);
+		res = true;
+		for (uint32_t i {0}; i < 10; ++i)
+			res &= res1[i] == sorted[sorted.size() - 1 - i];
+		CHECK_EQ(res, true);
+
+		mc::vector<uint32_t> res2 = mc::top_k<uint32_t>(vec0, 0);
+		CHECK_EQ(res2.size(), 0);
+	}
+
+	TEST(top_k_accumulator)
+	{
+		mc::top_k_accumulator<uint32_t, mc::greater<uint32_t>> acc0(3);
+		CHECK_EQ(acc0.empty(), true);
+		CHECK_EQ(acc0.max_size(), 3);
+
+		CHECK_EQ(acc0.push(5), true);
+		CHECK_EQ(acc0.push(1), true);
+		CHECK_EQ(acc0.push(3), true);
+		CHECK_EQ(acc0.size(), 3);
+		CHECK_EQ(acc0.threshold(), 1);
+
+		CHECK_EQ(acc0.push(0), false);
+		CHECK_EQ(acc0.push(4), true);
+		CHECK_EQ(acc0.threshold(), 3);
+		CHECK_EQ(acc0.size(), 3);
+
+		mc::vector<uint32_t> res0 = acc0.sorted();
+		CHECK_EQ(res0.size(), 3);
+		CHECK_EQ(res0[0], 5);
+		CHECK_EQ(res0[1], 4);
+		CHECK_EQ(res0[2], 3);
+
+		acc0.clear();
+		CHECK_EQ(acc0.empty(), true);
+
+		mc::top_k_accumulator<uint32_t> acc1(0);
+		CHECK_EQ(acc1.push(1), false);
+		CHECK_EQ(acc1.size(), 0);
+	}
+}
@@ -0,0 +1,78 @@
+#include "unit.hh"
+
+#include <array.hh>
+#include <span.hh>
+#include <vector.hh>
+
+GROUP(span)
+{
+	void fill_index(mc::span<uint32_t> sp)
+	{
+		for (uint32_t i {0}; i < sp.size(); ++i)
+			sp[i] = i;
+	}
+
+	uint32_t sum(mc::array_view<uint32_t> av)
+	{
+		uint32_t res {0};
+		for (uint32_t i {0}; i < av.size(); ++i)
+			res += av[i];
+
+		return res;
+	}
+
+	TEST(ctor)
+	{
+		uint32_t arr0[5] {0, 0, 0, 0, 0};
+		mc::span sp0(arr0);
+		CHECK_EQ(sp0.size(), 5);
+		CHECK_EQ(sp0.data(), arr0);
+
+		fill_index(arr0);
+		for (uint32_t i {0}; i < 5; ++i)
+			CHECK_EQ(arr0[i], i);
+
+		mc::vector<uint32_t> vec0(5, 0);
+		fill_index(vec0);
+		for (uint32_t i {0}; i < 5; ++i)
+			CHECK_EQ(vec0[i], i);
+
+		mc::array<uint32_t, 5> arr1 {};
+		fill_index(arr1);
+		for (uint32_t i {0}; i < 5; ++i)
+			CHECK_EQ(arr1[i], i);
+
+		mc::span<uint32_t> sp1;
+		CHECK_EQ(sp1.empty(), true);
+	}
+
+	TEST(array_view)
+	{
+		uint32_t           arr0[5] {0, 1, 2, 3, 4};
+		mc::span<uint32_t> sp0(arr0);
+		CHECK_EQ(sum(sp0), 10);
+
+		mc::array_view<uint32_t> av0 = sp0;
+		CHECK_EQ(av0.data(), sp0.data());
+		CHECK_EQ(av0.size(), sp0.size());
+
+		sp0.front() = 10;
+		sp0.back() = 40;
+		CHECK_EQ(av0[0], 10);
+		CHECK_EQ(av0[4], 40);
+	}
+
+	TEST(subarr)
+	{
+		uint32_t           arr0[5] {0, 1, 2, 3, 4};
+		mc::span<uint32_t> sp0(arr0);
+
+		mc::span<uint32_t> sp1 = sp0.subarr(2, 3);
+		CHECK_EQ(sp1.size(), 3);
+		fill_index(sp1);
+		CHECK_EQ(arr0[1], 1);
+		CHECK_EQ(arr0[2], 0);
+		CHECK_EQ(arr0[3], 1);
+		CHECK_EQ(arr0[4], 2);
+	}
+}
@@ -0,0 +1,51 @@
+#include "unit.hh"
+
+#include <strided_view.hh>
+
+GROUP(strided_view)
+{
+	TEST(ctor)
+	{
+		uint32_t                   arr0[9] {0, 1, 2, 3, 4, 5, 6, 7, 8};
+		mc::strided_view<uint32_t> sv0(arr0, 3, 3);
+		CHECK_EQ(sv0.size(), 3);
+		CHECK_EQ(sv0.stride(), 3);
+		CHECK_EQ(sv0.contiguous(), false);
+		for (uint32_t i {0}; i < sv0.size(); ++i)
+			CHECK_EQ(sv0[i], i * 3);
+		CHECK_EQ(sv0.back(), 6);
+
+		mc::strided_view<uint32_t> sv1 = mc::span<uint32_t>(arr0);
+		CHECK_EQ(sv1.size(), 9);
+		CHECK_EQ(sv1.contiguous(), true);
+
+		sv0[1] = 30;
+		CHECK_EQ(arr0[3], 30);
+
+		mc::strided_view<uint32_t const> sv2(arr0, 5, 2);
+		CHECK_EQ(sv2[2], 4);
+	}
+
+	TEST(subarr)
+	{
+		uint32_t                   arr0[9] {0, 1, 2, 3, 4, 5, 6, 7, 8};
+		mc::strided_view<uint32_t> sv0(arr0, 5, 2);
+
+		mc::strided_view<uint32_t> sv1 = sv0.subarr(1, 3);
+		CHECK_EQ(sv1.size(), 3);
+		CHECK_EQ(sv1[0], 2);
+		CHECK_EQ(sv1[2], 6);
+
+		mc::strided_view<uint32_t> sv2 = sv0.every(2);
+		CHECK_EQ(sv2.size(), 3);
+		CHECK_EQ(sv2.stride(), 4);
+		CHECK_EQ(sv2[0], 0);
+		CHECK_EQ(sv2[1], 4);
+		CHECK_EQ(sv2[2], 8);
+
+		mc::strided_view<uint32_t> sv3 = sv0.every(0);
+		CHECK_EQ(sv3.size(), 5);
+		CHECK_EQ(sv3.stride(), 2);
+		CHECK_EQ(sv3[4], 8);
+	}
+}
@@ -0,0 +1,92 @@
+#include "unit.hh"
+
+#include <string.hh>
+#include <string_builder.hh>
+
+#include <string.h>
+
+GROUP(string_builder)
+{
+	TEST(append)
+	{
+		mc::string_builder builder;
+		CHECK_EQ(builder.empty(), true)
+		CHECK_EQ(builder.to_string(), "")
+		CHECK_EQ(builder.chunks().size(), 0)
+
+		builder.append("Hello");
+		builder.push_back(',');
+		builder.append(1, ' ');
+		builder += "World!";
+		CHECK_EQ(builder.size(), 13)
+		CHECK_EQ(builder.to_string(), "Hello, World!")
+
+		char* str = builder.append_uninitialized(3);
+		memcpy(str, "!!!", 3);
+		CHECK_EQ(builder.to_string(), "Hello, World!!!!")
+
+		builder.clear();
+		CHECK_EQ(builder.empty(), true)
+		builder.append("abc");
+		CHECK_EQ(builder.to_string(), "abc")
+	}
+
+	TEST(move)
+	{
+		mc::string         large(1000, 'a');
+		mc::string_builder builder0;
+		builder0.append(large);
+
+		mc::string_builder builder1(static_cast<mc::string_builder&&>(builder0));
+		CHECK_EQ(builder1.size(), 1000)
+		CHECK_EQ(builder0.empty(), true)
+		CHECK_EQ(builder0.chunks().size(), 0)
+
+		builder0.append("abc");
+		builder0 = static_cast<mc::string_builder&&>(builder1);
+		CHECK_EQ(builder0.size(), 1000)
+		CHECK_EQ(builder0.to_string(), large)
+		CHECK_EQ(builder1.empty(), true)
+
+		mc::vector<mc::string_builder> builders;
+		builders.emplace_back(static_cast<mc::string_builder&&>(builder0));
+		builders.emplace_back().append("def");
+		CHECK_EQ(builders[0].size(), 1000)
+		CHECK_EQ(builders[1].to_string(), "def")
+	}
+
+	TEST(chunks)
+	{
+		mc::string_builder builder;
+		mc::string         expected;
+
+		// Pieces of every size straddle the chunk boundaries.
+		for (uint32_t i {0}; i < 2000; ++i)
+		{
+			mc::string piece(i % 97, static_cast<char>('a' + i % 26));
+			builder.append(piece);
+			expected.append(piece);
+		}
+
+		mc::string large(5000, 'z');
+		builder.append(large);
+		expected.append(large);
+
+		CHECK_EQ(builder.size(), expected.size())
+
+		mc::string str = builder.to_string();
+		CHECK_EQ(str, expected)
+		CHECK_EQ(str.capacity(), expected.size())
+
+		mc::vector<mc::string_view> chunks = builder.chunks();
+		CHECK_GT(chunks.size(), 1)
+
+		uint32_t pos {0};
+		for (uint32_t i {0}; i < chunks.size(); ++i)
+		{
+			CHECK_EQ(chunks[i], mc::string_view(expected.data() + pos, chunks[i].size()))
+			pos += chunks[i].size();
+		}
+		CHECK_EQ(pos, expected.size())
+	}
+}
@@ -0,0 +1,98 @@
+#include "unit.hh"
+
+#include <string_search.hh>
+#include <string_view.hh>
+
+#include <string.h>
+
+GROUP(string_search)
+{
+	TEST(find)
+	{
+		mc::string_searcher searcher("token=");
+		CHECK_EQ(searcher.needle() == "token=", true);
+
+		mc::string_view log("user=bob token=abc path=/ token=def");
+		CHECK_EQ(searcher.find(log), 9);
+		CHECK_EQ(searcher.find(log, 10), 26);
+		CHECK_EQ(searcher.find(log, 27), UINT32_MAX);
+		CHECK_EQ(searcher.find("token"), UINT32_MAX);
+		CHECK_EQ(searcher.find(""), UINT32_MAX);
+
+		mc::string_searcher single("=");
+		CHECK_EQ(single.find(log, 5), 14);
+		CHECK_EQ(mc::string_searcher("").find(log), UINT32_MAX);
+	}
+
+	TEST(find_long)
+	{
+		// Matches inside and after full SIMD registers, for each needle kind.
+		char buf[300];
+		memset(buf, 'e', sizeof(buf));
+		char const* needles[] {"eeez", "qeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"};
+		for (char const* needle : needles)
+		{
+			uint32_t size = strlen(needle);
+			memcpy(buf + 100, needle, size);
+			memcpy(buf + 300 - size, needle, size);
+
+			mc::string_searcher searcher(needle);
+			mc::string_view     str(buf, sizeof(buf));
+			CHECK_EQ(searcher.find(str), 100);
+			CHECK_EQ(searcher.find(str, 101), 300 - size);
+
+			memset(buf + 100, 'e', size);
+			memset(buf + 300 - size, 'e', size);
+		}
+	}
+
+	TEST(find_all)
+	{
+		mc::string_searcher searcher("aba");
+		mc::vector<uint32_t> res = searcher.find_all("abababa xaba");
+		CHECK_EQ(res.size(), 4);
+		CHECK_EQ(res[0], 0);
+		CHECK_EQ(res[1], 2);
+		CHECK_EQ(res[2], 4);
+		CHECK_EQ(res[3], 9);
+
+		CHECK_EQ(searcher.find_all("xyz").size(), 0);
+	}
+
+	TEST(char_set)
+	{
+		mc::char_set set(" \t\r\n");
+		CHECK_EQ(set.contains('\t'), true);
+		CHECK_EQ(set.contains('a'), false);
+		set.add('\xe9');
+		CHECK_EQ(set.contains('\xe9'), true);
+		// Shares nibbles with '\xe9' and ' ', but is not in the set.
+		CHECK_EQ(set.contains('\x29'), false);
+		CHECK_EQ(set.contains('\xa0'), false);
+
+		// Full SIMD blocks and tails, ASCII and non-ASCII bytes.
+		char buf[70];
+		memset(buf, 'a', sizeof(buf));
+		buf[5] = '\x29';
+		buf[20] = '\xe9';
+		buf[40] = '\xa0';
+		buf[66] = '\n';
+		mc::string_view str(buf, sizeof(buf));
+
+		CHECK_EQ(set.find(str), 20);
+		CHECK_EQ(set.find(str, 21), 66);
+		CHECK_EQ(set.find(str, 67), UINT32_MAX);
+		CHECK_EQ(set.rfind(str), 66);
+		CHECK_EQ(set.rfind(str, 65), 20);
+		CHECK_EQ(set.rfind(str, 19), UINT32_MAX);
+
+		mc::char_set letters("a");
+		CHECK_EQ(letters.find_not(str), 5);
+		CHECK_EQ(letters.find_not(str, 41), 66);
+		CHECK_EQ(letters.find_not(str, 67), UINT32_MAX);
+		CHECK_EQ(letters.rfind_not(str), 66);
+		CHECK_EQ(letters.rfind_not(str, 39), 20);
+		CHECK_EQ(letters.rfind_not(str, 4), UINT32_MAX);
+		CHECK_EQ(mc::char_set().find(str), UINT32_MAX);
+	}
+}
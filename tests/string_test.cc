@@ -1,6 +1,7 @@
 #include "unit.hh"
 
 #include <string.hh>
+#include <string_search.hh>
 
 #include <string.h>
 
@@ -84,17 +85,20 @@ GROUP(string)
 
 	TEST(reserve)
 	{
+		// 15 with the default layout, 23 with STRING_COMPACT.
+		uint32_t small_cap = mc::string().capacity();
+
 		mc::string str0;
 		CHECK_EQ(str0.size(), 0)
-		CHECK_EQ(str0.capacity(), 15)
+		CHECK_EQ(str0.capacity(), small_cap)
 
 		str0.reserve(12);
 		CHECK_EQ(str0.size(), 0)
-		CHECK_EQ(str0.capacity(), 15)
+		CHECK_EQ(str0.capacity(), small_cap)
 
-		str0.reserve(18);
+		str0.reserve(small_cap + 3);
 		CHECK_EQ(str0.size(), 0)
-		CHECK_EQ(str0.capacity(), 18)
+		CHECK_EQ(str0.capacity(), small_cap + 3)
 
 		str0.reserve(32);
 		CHECK_EQ(str0.size(), 0)
@@ -103,20 +107,27 @@ GROUP(string)
 
 	TEST(fit)
 	{
+		uint32_t small_cap = mc::string().capacity();
+
 		mc::string str0("Hello World");
 		CHECK_EQ(str0.size(), 11)
-		CHECK_EQ(str0.capacity(), 15)
+		CHECK_EQ(str0.capacity(), small_cap)
 
 		str0.fit();
-		CHECK_EQ(str0.capacity(), 15)
+		CHECK_EQ(str0.capacity(), small_cap)
 
 		mc::string str1;
-		str1.reserve(18);
-		CHECK_EQ(str1.capacity(), 18)
+		str1.reserve(small_cap + 3);
+		CHECK_EQ(str1.capacity(), small_cap + 3)
+
+		// The capacity doubles until it fits, 72 with the default layout.
+		uint32_t cap1 = small_cap + 3;
+		while (cap1 < 63)
+			cap1 *= 2;
 
 		str1 = "This is a very long string containing the sequence Hello World!";
 		CHECK_EQ(str1.size(), 63)
-		CHECK_EQ(str1.capacity(), 72)
+		CHECK_EQ(str1.capacity(), cap1)
 
 		str1.fit();
 		CHECK_EQ(str1.capacity(), 63)
@@ -166,6 +177,34 @@ GROUP(string)
 			CHECK_EQ(str4[i], 'a')
 	}
 
+	TEST(resize_and_overwrite)
+	{
+		mc::string str0("Hello");
+		str0.resize_and_overwrite(40, [&](char* str, uint32_t count) {
+			CHECK_EQ(strncmp(str, "Hello", 5), 0)
+			CHECK_EQ(count, 40)
+			memcpy(str + 5, " World!", 7);
+			return 12u;
+		});
+		CHECK_EQ(str0.size(), 12)
+		CHECK_EQ(str0, "Hello World!")
+
+		// Shrinking keeps the first count characters.
+		str0.resize_and_overwrite(5, [&](char* str, uint32_t count) {
+			CHECK_EQ(strncmp(str, "Hello", count), 0)
+			str[0] = 'J';
+			return count;
+		});
+		CHECK_EQ(str0, "Jello")
+
+		mc::string str1;
+		str1.resize_and_overwrite(8, [](char* str, uint32_t) {
+			memcpy(str, "abc", 3);
+			return 3u;
+		});
+		CHECK_EQ(str1, "abc")
+	}
+
 	TEST(assign)
 	{
 		char const* long_str =
@@ -186,9 +225,13 @@ GROUP(string)
 		mc::string str1("Large string for test");
 		CHECK_EQ(str1.size(), 21)
 
+		// A large string doubles its capacity, 42 with the default layout, while a small
+		// one allocates the exact size.
+		uint32_t cap1 = str1.size() > mc::string().capacity() ? 42 : 29;
+
 		str1 = str0;
 		CHECK_EQ(str1.size(), 29)
-		CHECK_EQ(str1.capacity(), 42)
+		CHECK_EQ(str1.capacity(), cap1)
 		CHECK_EQ(strcmp(str1.data(), "This is a longer Hello World!"), 0)
 
 		mc::string str2;
@@ -200,7 +243,7 @@ GROUP(string)
 
 		str2 = static_cast<mc::string&&>(str1);
 		CHECK_EQ(str2.size(), 29)
-		CHECK_EQ(str2.capacity(), 42)
+		CHECK_EQ(str2.capacity(), cap1)
 		CHECK_EQ(strcmp(str2.data(), "This is a longer Hello World!"), 0)
 		CHECK_EQ(str1.size(), 0); // NOLINT(clang-analyzer-cplusplus.Move
 
@@ -661,6 +704,86 @@ GROUP(string)
 		}
 	}
 
+	TEST(append_uninitialized)
+	{
+		mc::string str0("Hello");
+
+		char* str = str0.append_uninitialized(7);
+		memcpy(str, " World!", 7);
+		CHECK_EQ(str0.size(), 12)
+		CHECK_EQ(str0, "Hello World!")
+
+		str = str0.append_uninitialized(20);
+		memset(str, 'a', 20);
+		CHECK_EQ(str0.size(), 32)
+		CHECK_EQ(str0.data()[32], '\0')
+		CHECK_EQ(str0.ends_with(mc::string(20, 'a')), true)
+
+		str = str0.append_uninitialized(100);
+		memset(str, 'b', 100);
+		CHECK_EQ(str0.size(), 132)
+		CHECK_EQ(str0.starts_with("Hello World!aaa"), true)
+		CHECK_EQ(str0.ends_with(mc::string(100, 'b')), true)
+
+		mc::string str1;
+		str1.append_uninitialized(0);
+		CHECK_EQ(str1, "")
+	}
+
+	TEST(concat)
+	{
+		mc::string      str0("Hello");
+		mc::string_view sv0("World");
+
+		mc::string str1 = mc::concat(str0, ", ", sv0, "!");
+		CHECK_EQ(str1, "Hello, World!")
+		CHECK_EQ(mc::concat(str0), "Hello")
+		CHECK_EQ(mc::concat("", mc::string_view(), mc::string()), "")
+
+		mc::string str2 = mc::concat(str1, " ", str1, " ", str1);
+		CHECK_EQ(str2.size(), 41)
+		CHECK_EQ(str2.capacity(), 41)
+
+		mc::string str3 = str0 + ", " + sv0 + "!";
+		CHECK_EQ(str3, str1)
+		mc::string str4 = "<" + str0 + mc::string(">");
+		CHECK_EQ(str4, "<Hello>")
+
+		// Rvalue strings are appended to in place.
+		mc::string str5(40, 'a');
+		str5.reserve(100);
+		char const* data = str5.data();
+		mc::string str6 = static_cast<mc::string&&>(str5) + sv0;
+		CHECK_EQ(str6.data(), data)
+		CHECK_EQ(str6.size(), 45)
+		CHECK_EQ(str6.ends_with("aWorld"), true)
+
+		// A chain on an rvalue string is appended at once.
+		mc::string str7 = static_cast<mc::string&&>(str6) + ", " + str0 + "!";
+		CHECK_EQ(str7.data(), data)
+		CHECK_EQ(str7.size(), 53)
+		CHECK_EQ(str7.ends_with("aWorld, Hello!"), true)
+
+		// Without room in the rvalue string, the result is allocated once.
+		mc::string str8(40, 'b');
+		mc::string str9 = static_cast<mc::string&&>(str8) + str2 + "!";
+		CHECK_EQ(str9.size(), 82)
+		CHECK_EQ(str9.capacity(), 82)
+		CHECK_EQ(str9.starts_with("bbb"), true)
+
+		// Pieces may view the rvalue string itself.
+		mc::string str10("abc");
+		str10.reserve(20);
+		mc::string str11 = static_cast<mc::string&&>(str10) + str10 + str10;
+		CHECK_EQ(str11, "abcabcabc")
+
+		// Concatenations combine on either side.
+		CHECK_EQ(mc::string(str0 + (sv0 + "!")), "HelloWorld!")
+		CHECK_EQ(mc::string((str0 + ", ") + (sv0 + "!")), "Hello, World!")
+		CHECK_EQ(mc::string(mc::string("<") + (str0 + ">")), "<Hello>")
+		CHECK_EQ(mc::string("[" + (mc::string("a") + "b") + "]"), "[ab]")
+	}
+
 	TEST(replace)
 	{
 		{
@@ -928,6 +1051,53 @@ GROUP(string)
 		CHECK_EQ(str1.size(), 15)
 	}
 
+	TEST(small_layout)
+	{
+		CHECK_EQ(sizeof(mc::string), STRING_SMALL_SIZE + 8)
+
+		char const* chars = "0123456789abcdefghijklmnopqrstuvwxyzABCD";
+
+		// Grows and shrinks across the small capacity, whatever the layout.
+		mc::string str0;
+		for (uint32_t i {0}; i < 40; ++i)
+		{
+			str0.push_back(chars[i]);
+			CHECK_EQ(str0.size(), i + 1)
+			CHECK_EQ(strncmp(str0.data(), chars, i + 1), 0)
+			CHECK_EQ(str0.data()[i + 1], '\0')
+		}
+		for (uint32_t i {40}; i > 0; --i)
+		{
+			str0.pop_back();
+			CHECK_EQ(str0.size(), i - 1)
+			CHECK_EQ(str0.data()[i - 1], '\0')
+		}
+
+		mc::string str1("0123456789abcdefghijklm");
+		CHECK_EQ(str1.size(), 23)
+		CHECK_EQ(str1, "0123456789abcdefghijklm")
+
+		mc::string str2(str1);
+		CHECK_EQ(str2, str1)
+
+		mc::string str3(static_cast<mc::string&&>(str1));
+		CHECK_EQ(str3, str2)
+		CHECK_EQ(str1.size(), 0)
+		CHECK_EQ(str1, "")
+
+		str3.erase(0, 10);
+		CHECK_EQ(str3, "abcdefghijklm")
+		str3.insert(3, "0123456789");
+		CHECK_EQ(str3, "abc0123456789defghijklm")
+		str3.append("nop");
+		CHECK_EQ(str3, "abc0123456789defghijklmnop")
+
+		mc::string str4("Hello");
+		str4.reserve(100);
+		CHECK_EQ(str4.capacity(), 100)
+		CHECK_EQ(str4, "Hello")
+	}
+
 	TEST(compare)
 	{
 		mc::string str0;
@@ -974,6 +1144,24 @@ GROUP(string)
 		CHECK_LT(res4, 0);
 	}
 
+	TEST(compare_binary)
+	{
+		mc::string str0(mc::string_view("a\0b", 3));
+		mc::string str1(mc::string_view("a\0c", 3));
+
+		CHECK_EQ(str0 == str1, false);
+		CHECK_LT(str0.compare(str1), 0);
+		CHECK_GT(str0.compare("a"), 0);
+		CHECK_EQ(str0.starts_with(mc::string_view("a\0", 2)), true);
+		CHECK_EQ(str1.ends_with(mc::string_view("\0c", 2)), true);
+
+		mc::string str2("ab");
+		CHECK_EQ(str2.starts_with("abc"), false);
+		CHECK_EQ(str2.ends_with(mc::string("abc")), false);
+		CHECK_EQ(mc::string().starts_with('a'), false);
+		CHECK_EQ(mc::string() == mc::string_view(), true);
+	}
+
 	TEST(starts_with)
 	{
 		mc::string str0("Hello World!");
@@ -1256,6 +1444,23 @@ GROUP(string)
 		CHECK_EQ(res13, UINT32_MAX);
 	}
 
+	TEST(find_of)
+	{
+		mc::string str0("path/to/some/file.txt, and some more text after it");
+
+		CHECK_EQ(str0.find_first_of("/."), 4);
+		CHECK_EQ(str0.find_first_of(mc::string_view(",;"), 5), 21);
+		CHECK_EQ(str0.find_first_not_of("pathto/"), 8);
+		CHECK_EQ(str0.find_last_of("/"), 12);
+		CHECK_EQ(str0.find_last_not_of("ti "), 46);
+
+		mc::char_set set("/");
+		CHECK_EQ(str0.find_first_of(set, 8), 12);
+		CHECK_EQ(str0.find_last_of(set, 11), 7);
+		CHECK_EQ(str0.find_first_not_of(set, 4), 5);
+		CHECK_EQ(str0.find_last_not_of(set, 4), 3);
+	}
+
 	TEST(comparison)
 	{
 		mc::string str0("Hello World!");
@@ -1,5 +1,6 @@
 #include "unit.hh"
 
+#include <string_search.hh>
 #include <string_view.hh>
 
 #include <string.h>
@@ -81,6 +82,34 @@ GROUP(string_view)
 		CHECK_LT(res4, 0);
 	}
 
+	TEST(compare_binary)
+	{
+		mc::string_view sv0("a\0b", 3);
+		mc::string_view sv1("a\0c", 3);
+
+		CHECK_EQ(sv0 == sv1, false);
+		CHECK_LT(sv0.compare(sv1), 0);
+		CHECK_GT(sv0.compare(mc::string_view("a", 1)), 0);
+		CHECK_EQ(sv0.starts_with(mc::string_view("a\0", 2)), true);
+		CHECK_EQ(sv1.ends_with(mc::string_view("\0c", 2)), true);
+
+		// Sizes handled by the word compare.
+		mc::string_view sv2("0123456789abcdef");
+		mc::string_view sv3("0123456789abcdeg");
+
+		for (uint32_t i {0}; i <= sv2.size(); ++i)
+		{
+			CHECK_EQ(sv2.substr(0, i) == sv3.substr(0, i), i < 16);
+			CHECK_EQ(sv2.substr(0, i).compare(sv3.substr(0, i)) < 0, i == 16);
+		}
+
+		CHECK_LT(mc::string_view("\x01").compare("\xff"), 0);
+		CHECK_EQ(mc::string_view("ab").starts_with("abc"), false);
+		CHECK_EQ(mc::string_view("ab").ends_with("abc"), false);
+		CHECK_EQ(mc::string_view().ends_with('a'), false);
+		CHECK_EQ(mc::string_view() == mc::string_view(), true);
+	}
+
 	TEST(starts_with)
 	{
 		mc::string_view sv0("Hello World!");
@@ -238,6 +267,99 @@ GROUP(string_view)
 		CHECK_EQ(res13, UINT32_MAX);
 	}
 
+	TEST(find_char_long)
+	{
+		// Matches in full SIMD registers and in the tails, for every register width.
+		char buf[200];
+		memset(buf, '.', sizeof(buf));
+		buf[3] = ':';
+		buf[70] = ':';
+		buf[197] = ':';
+		mc::string_view sv0(buf, sizeof(buf));
+
+		CHECK_EQ(sv0.find(':'), 3);
+		CHECK_EQ(sv0.find(':', 4), 70);
+		CHECK_EQ(sv0.find(':', 71), 197);
+		CHECK_EQ(sv0.find(':', 198), UINT32_MAX);
+		CHECK_EQ(sv0.find(':', 500), UINT32_MAX);
+		CHECK_EQ(sv0.find('/'), UINT32_MAX);
+
+		CHECK_EQ(sv0.rfind(':'), 197);
+		CHECK_EQ(sv0.rfind(':', 196), 70);
+		CHECK_EQ(sv0.rfind(':', 69), 3);
+		CHECK_EQ(sv0.rfind(':', 2), UINT32_MAX);
+		CHECK_EQ(sv0.rfind('/'), UINT32_MAX);
+
+		// A search for '\xff' must not match the padding of the tail.
+		mc::string_view sv1(buf, 5);
+		CHECK_EQ(sv1.find('\xff'), UINT32_MAX);
+		CHECK_EQ(sv1.rfind('\xff'), UINT32_MAX);
+		CHECK_EQ(mc::string_view().rfind('.'), UINT32_MAX);
+	}
+
+	TEST(find_substr_long)
+	{
+		// A partial match of the prefix overlapping the real one.
+		mc::string_view sv0("aaab aab");
+		CHECK_EQ(sv0.find("aab"), 1);
+		CHECK_EQ(sv0.rfind("aab"), 5);
+		CHECK_EQ(sv0.rfind("aab", 6), 1);
+		CHECK_EQ(sv0.contains("aab"), true);
+		CHECK_EQ(sv0.rfind("aaab", 3), 0);
+
+		// Short needles through the SIMD filter, long ones through Horspool.
+		char buf[400];
+		memset(buf, 'x', sizeof(buf));
+		char const* needles[] {
+			"ab", "abcxxyz", "0123456789abcdef0123456789abcdef",
+			"0123456789abcdef0123456789abcdef0123456789abcdef-"};
+		for (char const* needle : needles)
+		{
+			uint32_t size = strlen(needle);
+			memcpy(buf + 37, needle, size);
+			memcpy(buf + 300, needle, size);
+			mc::string_view sv1(buf, sizeof(buf));
+
+			CHECK_EQ(sv1.find(needle), 37);
+			CHECK_EQ(sv1.find(needle, 38), 300);
+			CHECK_EQ(sv1.find(needle, 301), UINT32_MAX);
+			CHECK_EQ(sv1.rfind(needle), 300);
+			CHECK_EQ(sv1.rfind(needle, 300 + size - 2), 37);
+			CHECK_EQ(sv1.rfind(needle, 37 + size - 2), UINT32_MAX);
+
+			memset(buf + 37, 'x', size);
+			memset(buf + 300, 'x', size);
+		}
+
+		// Periodic needle, matches overlapping each other.
+		mc::string_view sv2("xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxy");
+		CHECK_EQ(sv2.find("xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxy"), 8);
+		CHECK_EQ(sv2.rfind("xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"), 6);
+		CHECK_EQ(sv2.find(""), UINT32_MAX);
+	}
+
+	TEST(find_of)
+	{
+		mc::string_view sv0("  key = value;  ");
+
+		CHECK_EQ(sv0.find_first_of("=;"), 6);
+		CHECK_EQ(sv0.find_first_of("=;", 7), 13);
+		CHECK_EQ(sv0.find_first_of("#"), UINT32_MAX);
+		CHECK_EQ(sv0.find_first_not_of(" "), 2);
+		CHECK_EQ(sv0.find_first_not_of(" ", 14), UINT32_MAX);
+		CHECK_EQ(sv0.find_last_of("=;"), 13);
+		CHECK_EQ(sv0.find_last_of("=;", 12), 6);
+		CHECK_EQ(sv0.find_last_not_of(" "), 13);
+		CHECK_EQ(sv0.find_last_not_of(" ", 1), UINT32_MAX);
+
+		mc::char_set spaces(" \t");
+		CHECK_EQ(sv0.find_first_of(spaces, 2), 5);
+		CHECK_EQ(sv0.find_first_not_of(spaces, 5), 6);
+		CHECK_EQ(sv0.find_last_of(spaces, 12), 7);
+		CHECK_EQ(sv0.find_last_not_of(spaces, 7), 6);
+		CHECK_EQ(mc::string_view().find_last_of(spaces), UINT32_MAX);
+	}
+
 	TEST(comparison)
 	{
 		mc::string_view sv0("Hello World!");
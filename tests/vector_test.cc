@@ -74,6 +74,46 @@ GROUP(vector)
 		int32_t val_ {-1};
 	};
 
+	// Counts the live objects, to catch assignments to unconstructed storage.
+	class vec_test_count
+	{
+	public:
+		vec_test_count(int32_t val)
+		: val_ {val}
+		{
+			++live;
+		}
+
+		vec_test_count(vec_test_count const& other)
+		: val_ {other.val_}
+		{
+			++live;
+		}
+
+		vec_test_count(vec_test_count&& other)
+		: val_ {other.val_}
+		{
+			++live;
+		}
+
+		~vec_test_count()
+		{
+			--live;
+		}
+
+		vec_test_count& operator=(vec_test_count const& other) = default;
+		vec_test_count& operator=(vec_test_count&& other) = default;
+
+		static inline int32_t live {0};
+
+		int32_t val_ {-1};
+	};
+
+	struct alignas(64) vec_test_aligned
+	{
+		int32_t val_ {-1};
+	};
+
 	TEST(ctor)
 	{
 		mc::vector<int32_t> vec0;
@@ -321,6 +361,40 @@ GROUP(vector)
 			CHECK_EQ(vec2[i].val_, static_cast<int32_t>(42 - i))
 	}
 
+	TEST(insert_realloc)
+	{
+		{
+			mc::vector<vec_test_count> vec0;
+			vec0.emplace_back(0);
+			vec0.emplace_back(1);
+			vec0.fit();
+
+			// Every insert reallocates, the inserted values are constructed in the gap.
+			vec0.insert(1, vec_test_count(2), 2);
+			CHECK_EQ(vec_test_count::live, 4)
+			vec0.fit();
+			vec0.insert(1, vec_test_count(3));
+			CHECK_EQ(vec_test_count::live, 5)
+			vec0.fit();
+			vec0.insert(0, {vec_test_count(4), vec_test_count(5)});
+			CHECK_EQ(vec_test_count::live, 7)
+
+			int32_t vals[] {4, 5, 0, 3, 2, 2, 1};
+			CHECK_EQ(vec0.size(), 7)
+			for (uint32_t i {0}; i < vec0.size(); ++i)
+				CHECK_EQ(vec0[i].val_, vals[i])
+		}
+		CHECK_EQ(vec_test_count::live, 0)
+
+		// Over-aligned storage goes through aligned_alloc.
+		mc::vector<vec_test_aligned> vec1;
+		for (int32_t i {0}; i < 20; ++i)
+			vec1.emplace_back().val_ = i;
+		CHECK_EQ(reinterpret_cast<uintptr_t>(vec1.data()) % 64, 0)
+		for (uint32_t i {0}; i < vec1.size(); ++i)
+			CHECK_EQ(vec1[i].val_, static_cast<int32_t>(i))
+	}
+
 	TEST(erase)
 	{
 		mc::vector<int32_t> vec0 {0, 1, 2, 3, 4};
@@ -0,0 +1,111 @@
+#include "unit.hh"
+
+#include <string_view.hh>
+#include <vector.hh>
+#include <views.hh>
+
+GROUP(views)
+{
+	TEST(filter_transform)
+	{
+		uint32_t arr0[10] {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+		auto odd_squares = mc::view<uint32_t>(arr0)
+		                       .filter([](uint32_t val) { return val % 2 == 1; })
+		                       .transform([](uint32_t val) { return val * val; });
+		CHECK_EQ(odd_squares.count(), 5);
+
+		mc::vector<uint32_t> vec0 = odd_squares.to_vector();
+		CHECK_EQ(vec0.size(), 5);
+		CHECK_EQ(vec0[0], 1);
+		CHECK_EQ(vec0[1], 9);
+		CHECK_EQ(vec0[4], 81);
+
+		// Consuming a view works on a copy.
+		uint32_t sum {0};
+		odd_squares.for_each([&](uint32_t val) { sum += val; });
+		CHECK_EQ(sum, 1 + 9 + 25 + 49 + 81);
+
+		CHECK_EQ(mc::view<uint32_t>(arr0).filter([](uint32_t) { return false; }).count(),
+		         0);
+
+		// The predicate isn't run until the view is consumed.
+		uint32_t calls {0};
+		auto     odds = mc::view<uint32_t>(arr0).filter([&](uint32_t val) {
+			++calls;
+			return val % 2 == 1;
+		});
+		CHECK_EQ(calls, 0);
+		CHECK_EQ(odds.front(), 1);
+		CHECK_EQ(calls, 2);
+		CHECK_EQ(odds.count(), 5);
+	}
+
+	TEST(take)
+	{
+		mc::vector<uint32_t> vec0 {5, 6, 7, 8};
+		CHECK_EQ(mc::view<uint32_t>(vec0).take(2).count(), 2);
+		CHECK_EQ(mc::view<uint32_t>(vec0).take(10).count(), 4);
+		CHECK_EQ(mc::view<uint32_t>(vec0).take(0).count(), 0);
+
+		// take doesn't evaluate the predicate past the last taken element.
+		uint32_t calls {0};
+		auto     counted = [&](uint32_t) {
+			++calls;
+			return true;
+		};
+		mc::view<uint32_t>(vec0).filter(counted).take(2).for_each([](uint32_t) {});
+		CHECK_EQ(calls, 2);
+
+		auto none = mc::view<uint32_t>(vec0).take(0);
+		none.pop_front();
+		CHECK_EQ(none.empty(), true);
+	}
+
+	TEST(enumerate_zip)
+	{
+		uint32_t arr0[3] {10, 20, 30};
+		uint32_t arr1[4] {1, 2, 3, 4};
+
+		bool res {true};
+		mc::view<uint32_t>(arr0).enumerate().for_each([&](auto item) {
+			res &= item.second == (item.first + 1) * 10;
+		});
+		CHECK_EQ(res, true);
+
+		uint32_t dot {0};
+		auto     zipped = mc::view<uint32_t>(arr0).zip(mc::view<uint32_t>(arr1));
+		CHECK_EQ(zipped.count(), 3);
+		zipped.for_each([&](auto item) { dot += item.first * item.second; });
+		CHECK_EQ(dot, 10 + 40 + 90);
+	}
+
+	TEST(chunk)
+	{
+		uint32_t arr0[7] {0, 1, 2, 3, 4, 5, 6};
+		auto     chunks = mc::view<uint32_t>(arr0).chunk(3);
+		CHECK_EQ(chunks.count(), 3);
+
+		mc::vector<uint32_t> sizes =
+			chunks.transform([](mc::array_view<uint32_t> av) { return av.size(); })
+				.to_vector();
+		CHECK_EQ(sizes[0], 3);
+		CHECK_EQ(sizes[1], 3);
+		CHECK_EQ(sizes[2], 1);
+		CHECK_EQ(chunks.front()[2], 2);
+
+		// A size of 0 is taken as 1.
+		CHECK_EQ(mc::view<uint32_t>(arr0).chunk(0).count(), 7);
+	}
+
+	TEST(string_view)
+	{
+		mc::string_view str("hello world");
+		CHECK_EQ(mc::view(str).filter([](char c) { return c == 'o'; }).count(), 2);
+
+		mc::vector<mc::string_view> words = mc::view(str).chunk(6).to_vector();
+		CHECK_EQ(words.size(), 2);
+		CHECK_EQ(words[0] == "hello ", true);
+		CHECK_EQ(words[1] == "world", true);
+	}
+}